@@ -0,0 +1,111 @@
+/**
+ * Steady-state allocation test for the scheduler simulation
+ *
+ * Builds the simulator without its main(), interposes malloc and friends
+ * with counting wrappers (glibc), and checks that once a SimContext has been
+ * warmed up by one run, simulating the same trace again allocates nothing.
+ *
+ * Usage: ./alloc_test
+ */
+
+#define SCHEDULER_NO_MAIN
+#include "scheduler_skeleton.c"
+
+#define TEST_PROCESSES 2000
+#define TEST_CPUS 4
+
+/************************* ALLOCATION COUNTING *************************/
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static bool counting = false;
+static long allocation_count = 0;
+
+void *malloc(size_t size) {
+    if (counting) allocation_count++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    if (counting) allocation_count++;
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    if (counting) allocation_count++;
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+    __libc_free(ptr);
+}
+
+/************************* TEST TRACE *************************/
+
+/**
+ * Fill 'processes' with a deterministic synthetic trace
+ *
+ * Arrivals are spread out so the ready queue and timeline see realistic
+ * churn; every fourth process joins a two-member gang and every job has a
+ * deadline of three times its burst.
+ */
+static void build_trace(Process *processes, int count) {
+    unsigned int seed = 12345;
+    sim_time_t arrival = 0;
+    for (int i = 0; i < count; i++) {
+        seed = seed * 1103515245u + 12345u;
+        arrival += TICKS((seed >> 16) % 3);
+        seed = seed * 1103515245u + 12345u;
+        processes[i].pid = i + 1;
+        processes[i].arrival_time = arrival;
+        processes[i].burst_time = TICKS(1 + (seed >> 16) % 8) + (sim_time_t)((seed >> 8) % 2) * (TIME_SCALE / 2);
+        processes[i].priority = (int)((seed >> 4) % 3);
+        processes[i].group_id = (i % 4 < 2) ? i / 4 : -1;
+        processes[i].deadline = arrival + 3 * processes[i].burst_time;
+        processes[i].period = 0;
+        processes[i].job = 0;
+        reset_process(&processes[i]);
+    }
+}
+
+/************************* MAIN FUNCTION *************************/
+
+int main(void) {
+    static Process processes[TEST_PROCESSES];
+    build_trace(processes, TEST_PROCESSES);
+
+    const double speeds[TEST_CPUS] = { 2.0, 1.0, 1.0, 0.5 };
+    const Algorithm algorithms[] = { FCFS, RR, SRTF, SJF, GANG, EDF, RM };
+    const Engine engines[] = { ENGINE_EVENT, ENGINE_TICK };
+    int failures = 0;
+
+    for (size_t a = 0; a < sizeof(algorithms) / sizeof(algorithms[0]); a++) {
+        for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); e++) {
+            SimConfig config = { algorithms[a], TICKS(DEFAULT_TIME_QUANTUM), engines[e] };
+            SimContext ctx;
+            init_sim_context(&ctx, TEST_PROCESSES, TEST_CPUS, speeds);
+
+            // Warm-up run lets the timeline reach its final capacity
+            sim_time_t expected = run_simulation(&ctx, processes, TEST_PROCESSES, &config);
+
+            allocation_count = 0;
+            counting = true;
+            sim_time_t total = run_simulation(&ctx, processes, TEST_PROCESSES, &config);
+            counting = false;
+
+            bool ok = allocation_count == 0 && total == expected;
+            printf("%s (%s): %ld allocation(s), total time %s -> %s\n",
+                   algorithm_name(config.algorithm), engines[e] == ENGINE_TICK ? "tick" : "event",
+                   allocation_count, time_str(total), ok ? "PASS" : "FAIL");
+            if (!ok) failures++;
+
+            cleanup_sim_context(&ctx);
+        }
+    }
+
+    printf("%s\n", failures == 0 ? "All steady-state runs allocation-free" : "Steady-state allocations detected");
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
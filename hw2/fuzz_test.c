@@ -0,0 +1,381 @@
+/**
+ * Differential fuzz test of the fast simulation paths
+ *
+ * Builds the simulator without its main() and checks random whole-tick traces
+ * against the reference tick loop (ENGINE_TICK). Each trace is simulated by the
+ * event engine in a fresh context and again in a context reused from an
+ * earlier run, for every algorithm. Any difference in per-process start or
+ * finish time, or in total time, is a failure. The trace is minimized
+ * (processes dropped, then arrivals and bursts shrunk) and printed in trace
+ * file format, so it can be replayed with ./scheduler -e tick / -e event.
+ *
+ * Traces use few distinct arrival times, bursts and priorities so that
+ * tie_breaker() ordering is exercised on most steps.
+ *
+ * SRTF is also checked one step at a time: the batched preemption pass and
+ * the original repeat-until-stable pass (SCHEDULER_SRTF_REFERENCE, which the
+ * tick engine also uses here) get the same random mid-run state, on up to
+ * FUZZ_SRTF_MAX_CPUS CPUs of mixed speeds, and must make the same placements.
+ *
+ * Usage: ./fuzz_test [iterations] [seed]
+ */
+
+#define SCHEDULER_NO_MAIN
+#define SCHEDULER_SRTF_REFERENCE
+#include "scheduler_skeleton.c"
+
+#define FUZZ_MAX_PROCESSES 12
+#define FUZZ_MAX_CPUS 4
+#define FUZZ_DEFAULT_ITERATIONS 10000
+#define FUZZ_MAX_ARRIVAL 12             // Latest arrival tick (3 * 4, see random_case)
+#define FUZZ_SRTF_MAX_PROCESSES 24
+#define FUZZ_SRTF_MAX_CPUS 20           // Several SRTF_LANES blocks
+
+/**
+ * One fuzz case: a trace plus the machine and policy it runs on
+ */
+typedef struct {
+    Process processes[FUZZ_MAX_PROCESSES];
+    int process_count;
+    int cpu_count;
+    SimConfig config;
+} FuzzCase;
+
+/**
+ * Start and finish times of every process plus the total time of one run
+ */
+typedef struct {
+    sim_time_t start[FUZZ_MAX_PROCESSES];
+    sim_time_t finish[FUZZ_MAX_PROCESSES];
+    sim_time_t total_time;
+} FuzzOutcome;
+
+static const Algorithm ALGORITHMS[] = { FCFS, RR, SRTF, SJF, GANG, EDF, RM };
+#define ALGORITHM_COUNT (sizeof(ALGORITHMS) / sizeof(ALGORITHMS[0]))
+
+/************************* TRACE GENERATION *************************/
+
+static uint64_t fuzz_state;
+
+static int fuzz_range(int lo, int hi) {
+    return lo + (int)(next_random(&fuzz_state) % (uint64_t)(hi - lo + 1));
+}
+
+/**
+ * Fill 'fc' with a random trace for 'algorithm'
+ *
+ * GANG traces get small groups that always fit the machine; EDF/RM traces get
+ * deadlines and periods (periods only matter to RM, which ranks by them).
+ * Periods exceed FUZZ_MAX_ARRIVAL, so replaying the printed trace with
+ * --horizon just past the last arrival releases exactly these jobs.
+ */
+static void random_case(FuzzCase *fc, Algorithm algorithm) {
+    fc->process_count = fuzz_range(1, FUZZ_MAX_PROCESSES);
+    fc->cpu_count = fuzz_range(1, FUZZ_MAX_CPUS);
+    fc->config.algorithm = algorithm;
+    fc->config.time_quantum = TICKS(fuzz_range(1, 4));
+    fc->config.engine = ENGINE_TICK;
+
+    for (int i = 0; i < fc->process_count; i++) {
+        Process *p = &fc->processes[i];
+        memset(p, 0, sizeof(*p));
+        p->pid = i + 1;
+        p->arrival_time = TICKS(fuzz_range(0, 3) * fuzz_range(0, 4));
+        p->burst_time = TICKS(fuzz_range(1, 6));
+        p->priority = fuzz_range(0, 2);
+        p->group_id = (algorithm == GANG && fuzz_range(0, 2) > 0) ? fuzz_range(0, 3) : -1;
+        p->deadline = TIME_UNSET;
+        if (algorithm == EDF || algorithm == RM) {
+            p->deadline = p->arrival_time + TICKS(fuzz_range(1, 12));
+            p->period = TICKS(fuzz_range(FUZZ_MAX_ARRIVAL + 1, FUZZ_MAX_ARRIVAL + 8));
+        }
+        reset_process(p);
+    }
+
+    // Keep every gang within the machine
+    if (algorithm == GANG) {
+        int members[FUZZ_MAX_PROCESSES] = { 0 };
+        for (int i = 0; i < fc->process_count; i++) {
+            Process *p = &fc->processes[i];
+            if (p->group_id >= 0 && ++members[p->group_id] > fc->cpu_count) p->group_id = -1;
+        }
+    }
+}
+
+/************************* DIFFERENTIAL CHECK *************************/
+
+static void run_case(SimContext *ctx, FuzzCase *fc, Engine engine, FuzzOutcome *outcome) {
+    SimConfig config = fc->config;
+    config.engine = engine;
+    outcome->total_time = run_simulation(ctx, fc->processes, fc->process_count, &config);
+    for (int i = 0; i < fc->process_count; i++) {
+        outcome->start[i] = fc->processes[i].start_time;
+        outcome->finish[i] = fc->processes[i].finish_time;
+    }
+}
+
+/**
+ * Simulate 'fc' with every engine and describe the first difference in 'why'
+ *
+ * Returns true if all runs agree with the tick reference.
+ */
+static bool check_case(FuzzCase *fc, SimContext *warm, char *why, size_t why_size) {
+    FuzzOutcome reference, event, reused;
+    SimContext ctx;
+    init_sim_context(&ctx, fc->process_count, fc->cpu_count, NULL);
+    run_case(&ctx, fc, ENGINE_TICK, &reference);
+    run_case(&ctx, fc, ENGINE_EVENT, &event);
+    cleanup_sim_context(&ctx);
+    run_case(&warm[fc->cpu_count - 1], fc, ENGINE_EVENT, &reused);
+
+    const FuzzOutcome *fast[] = { &event, &reused };
+    const char *names[] = { "event engine", "reused context" };
+    for (int f = 0; f < 2; f++) {
+        if (fast[f]->total_time != reference.total_time) {
+            snprintf(why, why_size, "%s: total time %s, tick %s", names[f], time_str(fast[f]->total_time),
+                     time_str(reference.total_time));
+            return false;
+        }
+        for (int i = 0; i < fc->process_count; i++) {
+            if (fast[f]->start[i] != reference.start[i] || fast[f]->finish[i] != reference.finish[i]) {
+                snprintf(why, why_size, "%s: PID %d runs %s-%s, tick %s-%s", names[f], fc->processes[i].pid,
+                         time_str(fast[f]->start[i]), time_str(fast[f]->finish[i]),
+                         time_str(reference.start[i]), time_str(reference.finish[i]));
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Shrink a failing case while it keeps failing
+ *
+ * Greedy: drop single processes, then move arrivals earlier and shorten
+ * bursts one tick at a time, until no single change preserves the failure.
+ */
+static void minimize_case(FuzzCase *fc, SimContext *warm, char *why, size_t why_size) {
+    bool shrunk = true;
+    while (shrunk) {
+        shrunk = false;
+        for (int i = 0; i < fc->process_count && fc->process_count > 1; i++) {
+            FuzzCase candidate = *fc;
+            memmove(&candidate.processes[i], &candidate.processes[i + 1],
+                    (candidate.process_count - i - 1) * sizeof(Process));
+            candidate.process_count--;
+            if (!check_case(&candidate, warm, why, why_size)) {
+                *fc = candidate;
+                shrunk = true;
+                i--;
+            }
+        }
+        for (int i = 0; i < fc->process_count; i++) {
+            for (int field = 0; field < 2; field++) {
+                FuzzCase candidate = *fc;
+                Process *p = &candidate.processes[i];
+                sim_time_t *value = field == 0 ? &p->arrival_time : &p->burst_time;
+                sim_time_t lowest = field == 0 ? 0 : TICKS(1);
+                if (*value - TICKS(1) < lowest) continue;
+                *value -= TICKS(1);
+                if (field == 0 && p->deadline != TIME_UNSET) p->deadline -= TICKS(1);
+                if (!check_case(&candidate, warm, why, why_size)) {
+                    *fc = candidate;
+                    shrunk = true;
+                }
+            }
+        }
+    }
+    check_case(fc, warm, why, why_size); // Leave the message of the final case
+}
+
+/**
+ * Print a case as a replayable trace and command line
+ */
+static void print_case(const FuzzCase *fc) {
+    static const char *names[] = { "FCFS", "RR", "SRTF", "SJF", "GANG", "EDF", "RM" };
+    bool realtime = fc->config.algorithm == EDF || fc->config.algorithm == RM;
+
+    printf("  # ./scheduler -f <trace> -a %s -c %d -q %s -e tick|event", names[fc->config.algorithm],
+           fc->cpu_count, time_str(fc->config.time_quantum));
+    if (realtime) printf(" --horizon %d", FUZZ_MAX_ARRIVAL + 1);
+    printf("\n");
+    for (int i = 0; i < fc->process_count; i++) {
+        const Process *p = &fc->processes[i];
+        printf("  %d %s %s %d %d", p->pid, time_str(p->arrival_time), time_str(p->burst_time), p->priority,
+               p->group_id);
+        if (realtime) printf(" %s %s", time_str(p->deadline - p->arrival_time), time_str(p->period));
+        printf("\n");
+    }
+}
+
+/************************* SRTF PASS CHECK *************************/
+
+/**
+ * One SRTF step: processes mid-run, which CPU runs which, and the CPU order
+ */
+typedef struct {
+    Process processes[FUZZ_SRTF_MAX_PROCESSES];
+    int process_count;
+    int running[FUZZ_SRTF_MAX_CPUS];     // CPU -> process index, -1 if idle
+    double speeds[FUZZ_SRTF_MAX_CPUS];
+    int cpu_count;
+    sim_time_t current_time;
+} SrtfStep;
+
+/**
+ * Fill 'step' with a random mid-run state
+ *
+ * Speeds of 0.5, 1 and 2 make cpu_order differ from CPU id order. Remaining
+ * times and priorities come from small ranges, so ties are common.
+ */
+static void random_srtf_step(SrtfStep *step) {
+    step->process_count = fuzz_range(1, FUZZ_SRTF_MAX_PROCESSES);
+    step->cpu_count = fuzz_range(1, FUZZ_SRTF_MAX_CPUS);
+    step->current_time = TICKS(4);
+    for (int c = 0; c < step->cpu_count; c++) {
+        step->running[c] = -1;
+        step->speeds[c] = (double)(1 << fuzz_range(0, 2)) / 2;
+    }
+
+    for (int i = 0; i < step->process_count; i++) {
+        Process *p = &step->processes[i];
+        memset(p, 0, sizeof(*p));
+        p->pid = i + 1;
+        p->arrival_time = TICKS(fuzz_range(0, 5));
+        p->burst_time = TICKS(8);
+        p->priority = fuzz_range(0, 2);
+        p->deadline = TIME_UNSET;
+        reset_process(p);
+        p->remaining_time = TICKS(fuzz_range(1, 6));
+
+        static const ProcessState states[] = { WAITING, READY, READY, COMPLETED, RUNNING };
+        p->state = states[fuzz_range(0, 4)];
+        if (p->state == RUNNING) {
+            int c = fuzz_range(0, step->cpu_count - 1);
+            if (step->running[c] >= 0 || p->arrival_time > step->current_time) {
+                p->state = READY;
+            } else {
+                step->running[c] = i;
+            }
+        }
+        if (p->state == RUNNING || fuzz_range(0, 1)) {
+            p->start_time = p->arrival_time;
+            p->response_time = 0;
+        }
+    }
+}
+
+/**
+ * Run one SRTF pass on a private copy of 'step', recording where everything ends up
+ */
+static void run_srtf_step(const SrtfStep *step, bool reference, int *placement, Process *processes) {
+    CPU cpus[FUZZ_SRTF_MAX_CPUS];
+    int cpu_order[FUZZ_SRTF_MAX_CPUS];
+    sim_time_t cpu_remaining[(FUZZ_SRTF_MAX_CPUS + SRTF_LANES - 1) / SRTF_LANES * SRTF_LANES];
+    int candidates[FUZZ_SRTF_MAX_CPUS];
+
+    memcpy(processes, step->processes, step->process_count * sizeof(Process));
+    for (int c = 0; c < step->cpu_count; c++) {
+        memset(&cpus[c], 0, sizeof(cpus[c]));
+        cpus[c].id = c;
+        cpus[c].speed = step->speeds[c];
+        cpus[c].gang = -1;
+        cpus[c].current_process = step->running[c] >= 0 ? &processes[step->running[c]] : NULL;
+    }
+    order_cpus_by_capacity(cpus, step->cpu_count, cpu_order);
+
+    if (reference) {
+        handle_srtf_preemption_reference(processes, step->process_count, cpus, step->cpu_count, cpu_order,
+                                         step->current_time);
+    } else {
+        handle_srtf_preemption(processes, step->process_count, cpus, step->cpu_count, cpu_order, cpu_remaining,
+                               candidates, step->current_time);
+    }
+    for (int c = 0; c < step->cpu_count; c++) {
+        placement[c] = cpus[c].current_process != NULL ? (int)(cpus[c].current_process - processes) : -1;
+    }
+}
+
+/**
+ * Compare the batched SRTF pass with the reference on 'step', describing the first difference in 'why'
+ */
+static bool check_srtf_step(const SrtfStep *step, char *why, size_t why_size) {
+    int expected[FUZZ_SRTF_MAX_CPUS], actual[FUZZ_SRTF_MAX_CPUS];
+    Process reference[FUZZ_SRTF_MAX_PROCESSES], batched[FUZZ_SRTF_MAX_PROCESSES];
+    run_srtf_step(step, true, expected, reference);
+    run_srtf_step(step, false, actual, batched);
+
+    for (int c = 0; c < step->cpu_count; c++) {
+        if (actual[c] != expected[c]) {
+            snprintf(why, why_size, "CPU %d runs PID %d, reference PID %d", c,
+                     actual[c] >= 0 ? actual[c] + 1 : -1, expected[c] >= 0 ? expected[c] + 1 : -1);
+            return false;
+        }
+    }
+    for (int i = 0; i < step->process_count; i++) {
+        if (batched[i].state != reference[i].state || batched[i].start_time != reference[i].start_time
+            || batched[i].response_time != reference[i].response_time) {
+            snprintf(why, why_size, "PID %d state %d start %s, reference state %d start %s", i + 1,
+                     batched[i].state, time_str(batched[i].start_time), reference[i].state,
+                     time_str(reference[i].start_time));
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Print an SRTF step: CPU speeds and occupants, then every process
+ */
+static void print_srtf_step(const SrtfStep *step) {
+    printf("  # time %s, CPUs (speed:PID):", time_str(step->current_time));
+    for (int c = 0; c < step->cpu_count; c++) {
+        printf(" %g:%d", step->speeds[c], step->running[c] >= 0 ? step->running[c] + 1 : -1);
+    }
+    printf("\n");
+    for (int i = 0; i < step->process_count; i++) {
+        const Process *p = &step->processes[i];
+        printf("  PID %d arrival %s remaining %s priority %d state %d\n", p->pid, time_str(p->arrival_time),
+               time_str(p->remaining_time), p->priority, p->state);
+    }
+}
+
+/************************* MAIN FUNCTION *************************/
+
+int main(int argc, char *argv[]) {
+    int iterations = argc > 1 ? atoi(argv[1]) : FUZZ_DEFAULT_ITERATIONS;
+    uint64_t seed = argc > 2 ? strtoull(argv[2], NULL, 0) : 1;
+    fuzz_state = seed;
+
+    // Warm contexts, one per CPU count, reused across cases like batch workers do
+    SimContext warm[FUZZ_MAX_CPUS];
+    for (int c = 0; c < FUZZ_MAX_CPUS; c++) init_sim_context(&warm[c], FUZZ_MAX_PROCESSES, c + 1, NULL);
+
+    int failures = 0;
+    char why[256];
+    for (int n = 0; n < iterations; n++) {
+        for (size_t a = 0; a < ALGORITHM_COUNT; a++) {
+            FuzzCase fc;
+            random_case(&fc, ALGORITHMS[a]);
+            if (check_case(&fc, warm, why, sizeof(why))) continue;
+
+            minimize_case(&fc, warm, why, sizeof(why));
+            printf("MISMATCH (iteration %d, %s): %s\n", n, algorithm_name(fc.config.algorithm), why);
+            print_case(&fc);
+            failures++;
+        }
+
+        SrtfStep step;
+        random_srtf_step(&step);
+        if (!check_srtf_step(&step, why, sizeof(why))) {
+            printf("MISMATCH (iteration %d, SRTF pass): %s\n", n, why);
+            print_srtf_step(&step);
+            failures++;
+        }
+    }
+
+    for (int c = 0; c < FUZZ_MAX_CPUS; c++) cleanup_sim_context(&warm[c]);
+    printf("%d case(s) and %d SRTF step(s), seed %" PRIu64 ": %s\n", iterations * (int)ALGORITHM_COUNT,
+           iterations, seed, failures == 0 ? "all fast paths match their references" : "mismatches found");
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -6,19 +6,40 @@
  * - Round Robin (RR)
  * - Shortest Remaining Time First (SRTF)
  * - Shortest Job First (SJF)
+ * - Gang scheduling (GANG) of process groups
+ * - Earliest Deadline First (EDF) and Rate Monotonic (RM) for periodic real-time tasks
  * 
  * Features:
- * - Multiple CPU support
- * - Visual timeline of execution
+ * - Multiple CPU support, including heterogeneous (big.LITTLE) CPU speeds
+ * - Fixed-point (sub-tick) time with event-driven stepping
+ * - Visual timeline of execution, optionally spilled to a memory-mapped file and paged by time window
  * - Process and CPU statistics
- * - CSV output for automated testing
+ * - CSV output for automated testing, plus CSV/JSON/binary-only output modes
+ * - Batch mode: many traces on a thread pool with one aggregated results file
+ * - Quantum optimizer: searches the RR/GANG quantum that minimizes an objective
+ * - Optional per-phase profile of the simulation loop (build with -DSCHEDULER_PROFILE)
+ * - Trace import from perf sched / ftrace sched_switch and sched_wakeup dumps
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
 #include <stdbool.h>
 #include <string.h>
 #include <limits.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef SCHEDULER_PROFILE
+#include <time.h>
+#endif
 
 /************************* CONSTANTS & DEFINITIONS *************************/
 
@@ -27,22 +48,96 @@ typedef enum {
     FCFS = 0,  // First-Come, First-Served
     RR   = 1,  // Round Robin
     SRTF = 2,  // Shortest Remaining Time First (preemptive)
-    SJF  = 3   // Shortest Job First (non-preemptive)
+    SJF  = 3,  // Shortest Job First (non-preemptive)
+    GANG = 4,  // Gang scheduling: a group's members run together (time-sliced)
+    EDF  = 5,  // Earliest Deadline First (preemptive)
+    RM   = 6   // Rate Monotonic: shorter period first (preemptive)
 } Algorithm;
 
+// Simulation engines
+typedef enum {
+    ENGINE_EVENT = 0,  // Jump straight to the next arrival, completion or quantum expiry
+    ENGINE_TICK  = 1   // Reference loop: advance one whole tick per step
+} Engine;
+
+// Result output formats
+typedef enum {
+    FORMAT_TEXT   = 0,  // Banner, timeline, human tables and the CSV section
+    FORMAT_CSV    = 1,  // CSV section only
+    FORMAT_JSON   = 2,  // One JSON document
+    FORMAT_BINARY = 3   // Fixed-layout records (see BinaryHeader)
+} OutputFormat;
+
+// Quantum optimizer objectives (each plus the optional switch cost)
+typedef enum {
+    OBJECTIVE_RESPONSE   = 0,  // Mean response time
+    OBJECTIVE_P99        = 1,  // 99th percentile response time
+    OBJECTIVE_TURNAROUND = 2,  // Mean turnaround time
+    OBJECTIVE_WAITING    = 3   // Mean waiting time
+} Objective;
+
 // Process states
 typedef enum {
     WAITING    = 0,  // Ready to run but not yet scheduled or arrived
     RUNNING    = 1,  // Currently executing on a CPU
     COMPLETED  = 2,  // Finished execution
-    READY      = 3   // In the ready queue (specifically for RR)
+    READY      = 3   // In the ready queue (specifically for RR, GANG, EDF and RM)
 } ProcessState;
 
+// Fixed-point simulation time: TIME_SCALE units per tick
+typedef int64_t sim_time_t;
+#define TIME_SCALE 1000000
+#define TIME_DIGITS 6              // Decimal digits of TIME_SCALE
+#define TICKS(n) ((sim_time_t)(n) * TIME_SCALE)
+#define TIME_UNSET ((sim_time_t)-1)
+#define TIME_NEVER INT64_MAX
+#define TIME_STR_SLOTS 16          // Rotating buffers used by time_str()
+#define TIME_STR_LENGTH 32         // Buffer size for one formatted time
+
 // Configuration constants
 #define DEFAULT_TIME_QUANTUM 2
-#define MAX_PROCESSES 500
-#define INITIAL_TIMELINE_CAPACITY 1000
+#define INITIAL_TIMELINE_CAPACITY 1000  // Segments, grown by doubling
+#define TIMELINE_INDEX_STRIDE 256       // Stored segments per sparse index entry
+#define INITIAL_TIMELINE_INDEX 64       // Index entries, grown by doubling
+#define TIMELINE_SPILL_WINDOW (512 * 1024) // Segments per spill mapping (a multiple of 64 KiB at 24 bytes each)
 #define MAX_LINE_LENGTH 256
+#define DEFAULT_CPU_SPEED 1.0
+#define MAX_PATH_LENGTH 4096
+#define BATCH_OUTPUT_BUFFER (1 << 20)   // stdio buffer for the batch results file
+#define OUTPUT_BYTES_PER_PROCESS 96     // Initial output buffer estimate per process row
+#define OUTPUT_BASE_BYTES 4096          // Initial output buffer estimate for everything else
+#define BINARY_MAGIC "SCHB"
+#define BINARY_VERSION 1
+#define OPTIMIZER_GRID_POINTS 9         // Coarse scan before golden-section refinement
+#define OPTIMIZER_MAX_TRIALS 64         // Upper bound on simulations per search
+#define OPTIMIZER_TOLERANCE (TIME_SCALE / 100)  // Stop refining below 0.01 tick
+#define GOLDEN_RATIO_CONJUGATE 0.6180339887498949
+#define DEFAULT_HORIZON_PERIODS 1000    // Cap on the default release horizon, in longest periods
+#define REPLICATION_ROUND 8             // Replications between confidence-interval checks
+#define REPLICATION_METRICS 3           // Metrics of print_average_stats
+#define IMPORT_LINE_LENGTH 1024        // Longest scheduler event line kept by the importer
+#define IMPORT_INITIAL_TASKS 1024      // Task table slots, doubled at half load
+#define IMPORT_STREAM_BUFFER (1 << 20) // stdio buffer for reading the dump
+#define DEFAULT_IMPORT_TICK_NS 1000000 // One tick per millisecond of traced time
+#define KERNEL_MAX_PRIO 140            // Kernel prio range is 0 (highest) .. 139
+#define SRTF_LANES 8                    // CPU remaining times compared per block (see first_preemptible_cpu)
+
+// Simulation loop profiling: compiled out unless SCHEDULER_PROFILE is defined
+#ifdef SCHEDULER_PROFILE
+#define PROFILE_RESET() memset(&profile, 0, sizeof(profile))
+#define PROFILE_STEP() (profile.steps++)
+#define PROFILE_BEGIN(phase) uint64_t profile_start_##phase = profile_clock()
+#define PROFILE_END(phase) profile_record(PHASE_##phase, profile_start_##phase)
+#define PROFILE_SCANS(phase, n) (profile.phases[PHASE_##phase].scans += (uint64_t)(n))
+#define PROFILE_COMPARES(phase, n) (profile.phases[PHASE_##phase].comparisons += (uint64_t)(n))
+#else
+#define PROFILE_RESET() ((void)0)
+#define PROFILE_STEP() ((void)0)
+#define PROFILE_BEGIN(phase) ((void)0)
+#define PROFILE_END(phase) ((void)0)
+#define PROFILE_SCANS(phase, n) ((void)0)
+#define PROFILE_COMPARES(phase, n) ((void)0)
+#endif
 
 // Display settings
 #define TIMELINE_WIDTH 80
@@ -72,16 +167,20 @@ const char *PROCESS_COLORS[] = {
  */
 typedef struct {
     int pid;              // Process ID
-    int arrival_time;     // Time when process becomes available
-    int burst_time;       // Total CPU time required
+    sim_time_t arrival_time;   // Time when process becomes available
+    sim_time_t burst_time;     // Total CPU time required (on a baseline CPU)
     int priority;         // Priority (higher value = higher priority)
-    int remaining_time;   // Remaining CPU time needed
+    sim_time_t remaining_time; // Remaining work needed (on a baseline CPU)
     ProcessState state;   // Current state (WAITING, RUNNING, etc.)
-    int start_time;       // When process first started (-1 if not started)
-    int finish_time;      // When process completed (-1 if not finished)
-    int waiting_time;     // Total time spent waiting
-    int quantum_used;     // Time units used in current quantum (for RR)
-    int response_time;    // Time between arrival and first execution
+    sim_time_t start_time;     // When process first started (TIME_UNSET if not started)
+    sim_time_t finish_time;    // Exact completion time (TIME_UNSET if not finished)
+    sim_time_t waiting_time;   // Total time spent waiting
+    sim_time_t quantum_used;   // Time used in current quantum (for RR)
+    sim_time_t response_time;  // Time between arrival and first execution
+    int group_id;         // Gang/group identifier (-1 if ungrouped)
+    sim_time_t deadline;  // Absolute deadline (TIME_UNSET if none)
+    sim_time_t period;    // Release period of a periodic task (0 if one-shot)
+    int job;              // Job number within its periodic task (0 for the first release)
 } Process;
 
 /**
@@ -90,82 +189,663 @@ typedef struct {
 typedef struct {
     int id;               // CPU identifier
     Process *current_process; // Process currently running (NULL if idle)
-    int idle_time;        // Total time CPU was idle
-    int busy_time;        // Total time CPU was busy
+    sim_time_t idle_time; // Total time CPU was idle
+    sim_time_t busy_time; // Total time CPU was busy
+    double speed;         // Work units executed per tick (1.0 = baseline core)
+    sim_time_t work_done; // Total work executed (baseline-CPU time)
+    int gang;             // Gang holding this CPU under GANG scheduling (-1 if none)
 } CPU;
 
 /**
  * Simple circular queue for RR scheduling
  */
 typedef struct {
-    int process_indices[MAX_PROCESSES]; // Array of process indices
+    int *process_indices; // Array of process indices
+    int capacity;         // Allocated slots
     int front;            // Index of front element
     int rear;             // Index of rear element
     int size;             // Current queue size
 } ReadyQueue;
 
+/**
+ * Binary heap of process indices ordered by EDF or RM priority
+ */
+typedef struct {
+    int *items;           // Heap-ordered process indices
+    int size;             // Jobs in the heap
+    int capacity;         // Allocated slots
+} JobHeap;
+
+/**
+ * Pair of (arrival time, process index) used to sort processes by arrival
+ */
+typedef struct {
+    sim_time_t arrival_time;
+    int process_idx;
+} ArrivalKey;
+
+/**
+ * Pair of (group id, process index) used to bucket processes into gangs
+ */
+typedef struct {
+    int group_id;
+    int process_idx;
+} GroupKey;
+
+/**
+ * A gang: all processes sharing a group id, always dispatched together
+ */
+typedef struct {
+    int group_id;         // Group identifier from the trace (-1 for an ungrouped process)
+    int first_member;     // Offset of the first member in GangTable.members
+    int member_count;     // Number of processes in the gang
+    int arrived_count;    // Members that have arrived so far
+    sim_time_t quantum_used; // Time used in the current time slice
+    bool running;         // Whether the gang currently holds CPUs
+} Gang;
+
+/**
+ * Gang scheduling state and co-scheduling waste counters
+ */
+typedef struct {
+    Gang *gangs;          // All gangs, ordered by first appearance in the trace
+    int gang_count;       // Number of gangs
+    int *members;         // Process indices grouped by gang
+    int *gang_of;         // Gang index of each process
+    GroupKey *keys;       // Scratch space for bucketing processes by group
+    ReadyQueue queue;     // Gangs whose members have all arrived, in dispatch order
+    sim_time_t fragmentation; // Free CPU time left idle while a queued gang did not fit
+    sim_time_t idle_waste;    // Reserved CPU time with no gang member left to run
+} GangTable;
+
+/**
+ * One contiguous stretch of a single CPU's execution history
+ */
+typedef struct {
+    sim_time_t start;     // Segment start (inclusive)
+    sim_time_t end;       // Segment end (exclusive)
+    int cpu;              // CPU index
+    int pid;              // Process ID running, or -1 if idle
+} TimelineSegment;
+
+/**
+ * Run-length encoded execution timeline
+ *
+ * Each CPU's current segment stays open and is extended while the same
+ * process keeps running, so memory grows with scheduling decisions rather than
+ * with time resolution. A segment is stored only once it closes, which keeps
+ * the store ordered by end time. The store is a growable array, or with
+ * spill_timeline() an unlinked append-only file written through a sliding
+ * mmap() window, so resident memory stays flat however long the run. The end
+ * time of every TIMELINE_INDEX_STRIDE-th stored segment forms a sparse index
+ * for seeking to any point in time (see TimelineReader).
+ */
+typedef struct {
+    TimelineSegment *segments; // Stored segments, or the spill file's write window
+    int64_t count;        // Segments stored
+    int64_t capacity;     // Segments allocated, or end of the write window
+    int64_t window_first; // First segment of the write window (0 in memory)
+    TimelineSegment *open; // Each CPU's unfinished segment (start TIME_UNSET if none)
+    int cpu_count;        // Number of CPUs recorded
+    int spill_fd;         // Spill file (-1 = in memory)
+    sim_time_t *index;    // End of segments 0, STRIDE, 2 * STRIDE, ...
+    int64_t index_count;
+    int64_t index_capacity;
+} Timeline;
+
+/**
+ * Sequential reader over the stored segments that overlap a time window
+ *
+ * Every CPU has exactly one segment containing the window's end (unless the
+ * run ends first); the store is ordered by end time, so once all of those
+ * have been read no later segment can start inside the window. Spilled
+ * segments are mapped read-only one TIMELINE_SPILL_WINDOW page at a time.
+ */
+typedef struct {
+    const Timeline *timeline;
+    int64_t next;         // Next stored segment to examine
+    sim_time_t from;      // Window start
+    sim_time_t to;        // Window end (exclusive)
+    int pending;          // CPUs whose segment containing 'to' is still unread
+    const TimelineSegment *page; // Segments page_first .. page_first + page_count - 1
+    int64_t page_first;
+    int64_t page_count;
+    bool mapped;          // 'page' is a private mapping of the spill file
+} TimelineReader;
+
+/**
+ * Which part of the timeline to show and where to keep it
+ */
+typedef struct {
+    const char *spill_dir; // --spill: directory for the spill file (NULL = in memory)
+    sim_time_t from;      // --window: first time shown
+    sim_time_t to;        // --window: end of the window (TIME_NEVER = end of run)
+    const char *export_path; // --export-timeline: CSV of the window's segments (NULL = none)
+} TimelineView;
+
+/**
+ * Scheduling parameters for one simulation run
+ */
+typedef struct {
+    Algorithm algorithm;  // Scheduling policy
+    sim_time_t time_quantum; // Time slice for RR and GANG
+    Engine engine;        // How the clock advances
+} SimConfig;
+
+/**
+ * Everything a simulation run needs, allocated once up front
+ *
+ * A context sized for N processes on C CPUs can run any trace of at most N
+ * processes again and again without touching the heap: per-step scratch
+ * buffers live here, and the timeline keeps its capacity between runs.
+ */
+typedef struct {
+    int process_capacity; // Largest trace this context can simulate
+    int cpu_count;        // Number of CPUs
+    CPU *cpus;            // CPU state
+    int *cpu_order;       // CPU indices, fastest first
+    ArrivalKey *arrival_keys; // Scratch space for sorting arrivals
+    int *arrival_order;   // Process indices ordered by arrival time
+    int *arrived_indices; // Processes arriving in the current step
+    sim_time_t *cpu_remaining; // SRTF: remaining time on each CPU in cpu_order, padded to SRTF_LANES
+    int *srtf_candidates; // SRTF: best ready processes of a step, at most one per CPU
+    ReadyQueue ready_queue; // RR ready queue
+    GangTable gangs;      // GANG scheduling state
+    JobHeap job_heap;     // EDF/RM ready jobs
+    Timeline timeline;    // Execution history of the last run
+    sim_time_t total_time; // Length of the last run
+} SimContext;
+
+/**
+ * Growable in-memory output, written out with a single fwrite()
+ */
+typedef struct {
+    char *data;           // Buffered bytes
+    size_t length;        // Bytes used
+    size_t capacity;      // Bytes allocated
+} OutputBuffer;
+
+/**
+ * Binary output header (native byte order, all times in TIME_SCALE units)
+ *
+ * Followed by process_count BinaryProcessRecords and cpu_count BinaryCpuRecords.
+ */
+typedef struct {
+    char magic[4];        // BINARY_MAGIC
+    uint32_t version;     // BINARY_VERSION
+    uint32_t algorithm;   // Algorithm value
+    uint32_t process_count;
+    uint32_t cpu_count;
+    uint32_t gang_count;  // 0 unless GANG
+    int64_t time_scale;   // TIME_SCALE
+    int64_t total_time;
+    int64_t time_quantum;
+    int64_t fragmentation; // GANG waste counters (0 otherwise)
+    int64_t idle_waste;
+} BinaryHeader;
+
+typedef struct {
+    int32_t pid;
+    int32_t priority;
+    int64_t arrival_time;
+    int64_t burst_time;
+    int64_t start_time;   // TIME_UNSET (-1) if never started
+    int64_t finish_time;  // TIME_UNSET (-1) if unfinished
+    int64_t response_time;
+} BinaryProcessRecord;
+
+typedef struct {
+    int32_t id;
+    int32_t reserved;     // Always 0
+    int64_t busy_time;
+    int64_t idle_time;
+    int64_t work_done;
+    double speed;
+} BinaryCpuRecord;
+
+/**
+ * Headline metrics of one finished run
+ */
+typedef struct {
+    int completed;        // Processes that finished
+    double avg_turnaround; // Averages over completed processes
+    double avg_waiting;
+    double avg_response;
+    sim_time_t makespan;  // Latest finish time
+    double utilization;   // Busy share of all CPU time, in percent
+} SimSummary;
+
+/**
+ * Deadline and schedulability metrics of a run with real-time jobs
+ */
+typedef struct {
+    int tasks;            // Periodic tasks
+    double utilization;   // Sum of burst/period over periodic tasks
+    double density;       // Sum of burst/min(deadline, period)
+    double max_density;   // Largest single-task density
+    double edf_bound;     // Density at or below which EDF is guaranteed (sufficient test)
+    double rm_bound;      // Density at or below which RM is guaranteed (sufficient test)
+    int jobs;             // Jobs with a deadline
+    int misses;           // Jobs that finished after their deadline (or never)
+    sim_time_t max_lateness; // Worst finish time past a deadline (0 if none missed)
+} RealTimeSummary;
+
+/**
+ * Queueing-model fit of a trace and the resulting waiting-time estimates
+ *
+ * Servers are the simulated CPUs, treated as identical at their mean speed.
+ * Estimates are INFINITY when the fitted system is unstable (utilization >= 1).
+ */
+typedef struct {
+    int samples;          // Processes used for the fit
+    int servers;          // c
+    double arrival_rate;  // lambda, arrivals per tick
+    double arrival_scv;   // Squared coefficient of variation of interarrival gaps
+    double mean_service;  // E[S] at the mean CPU speed, in ticks
+    double service_scv;   // Squared coefficient of variation of service times
+    double utilization;   // rho = lambda * E[S] / c
+    double mmc_wait;      // M/M/c (Erlang C)
+    double mg1_wait;      // M/G/1 on one pooled server c times as fast (Pollaczek-Khinchine)
+    double kingman_wait;  // G/G/c: Kingman for c = 1, Allen-Cunneen beyond
+} QueueingEstimate;
+
+/**
+ * Shared state of a Monte-Carlo replication run
+ *
+ * Workers claim replication numbers below round_end; the main thread widens
+ * round_end one round at a time until the intervals are narrow enough.
+ */
+typedef struct {
+    const Process *model; // Trace whose jobs are resampled
+    int model_count;
+    const sim_time_t *gaps; // Interarrival gaps of the model trace
+    int gap_count;
+    sim_time_t first_arrival;
+    uint64_t seed;        // Base seed; replication r uses its own stream
+    const SimConfig *config;
+    int cpu_count;
+    const double *cpu_speeds;
+    SimSummary *results;  // One summary per replication, in replication order
+    int next_rep;         // Next replication to claim
+    int round_end;        // Replications below this may run
+    int finished;         // Replications completed in the current rounds
+    bool done;            // No more rounds
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;
+    pthread_cond_t round_done;
+} ReplicationJob;
+
+/**
+ * Mean and 95% confidence interval of one metric over replications
+ */
+typedef struct {
+    const char *name;
+    double mean;
+    double half_width;    // t(0.975, n-1) * s / sqrt(n)
+} MetricEstimate;
+
+#ifdef SCHEDULER_PROFILE
+/**
+ * Phases of one simulation step, in loop order
+ */
+typedef enum {
+    PHASE_ARRIVALS = 0,
+    PHASE_QUANTUM_EXPIRY,  // RR and GANG time slices
+    PHASE_SRTF_PREEMPTION,
+    PHASE_ASSIGNMENT,      // Including GANG and EDF/RM dispatch
+    PHASE_NEXT_EVENT,
+    PHASE_TIMELINE,
+    PHASE_WAITING,
+    PHASE_EXECUTE,
+    PHASE_COUNT
+} ProfilePhase;
+
+/**
+ * Counters of one phase
+ */
+typedef struct {
+    uint64_t calls;       // Times the phase ran
+    uint64_t nanoseconds; // Wall time spent in it
+    uint64_t scans;       // Processes, CPUs or segments visited
+    uint64_t comparisons; // Scheduling-order comparisons made
+} PhaseProfile;
+
+/**
+ * Profile of the last run_simulation() on this thread
+ */
+typedef struct {
+    PhaseProfile phases[PHASE_COUNT];
+    uint64_t steps;       // Loop iterations (ticks or events)
+} Profile;
+#endif
+
+/**
+ * Command line options
+ */
+typedef struct {
+    Algorithm algorithm;  // -a
+    int cpu_count;        // -c
+    sim_time_t time_quantum; // -q
+    char *input_file;     // -f: single trace
+    char *speed_list;     // -s: per-CPU speeds
+    Engine engine;        // -e
+    char *batch_source;   // -b: trace directory or manifest (batch mode)
+    char *output_file;    // -o: batch results file (stdout if NULL)
+    int thread_count;     // -j: batch worker threads (0 = one per online CPU)
+    OutputFormat format;  // --format
+    bool optimize;        // --optimize: search the quantum instead of a single run
+    Objective objective;  // --optimize <objective>
+    sim_time_t switch_cost; // --switch-cost: charged per context switch
+    char *quantum_range;  // --quantum-range lo,hi (NULL = default)
+    sim_time_t horizon;   // --horizon: release periodic jobs before this time (TIME_UNSET = default)
+    int replications;     // --replicate: Monte-Carlo replications (0 = single run)
+    uint64_t seed;        // --seed: base seed of the synthetic traces
+    double ci_width;      // --ci-width: stop once every 95% CI is narrower (0 = run all)
+    bool estimate;        // --estimate: print queueing-model estimates without simulating
+    char *spill_dir;      // --spill: keep the timeline in a file under this directory
+    sim_time_t window_from; // --window from,to: part of the timeline to print or export
+    sim_time_t window_to; // (TIME_NEVER = end of run)
+    char *export_timeline; // --export-timeline: CSV file of the window's segments
+    char *import_file;    // --import: perf sched / ftrace dump to convert into a trace
+    int64_t tick_ns;      // --tick-us: traced time per simulated tick, in ns
+} Options;
+
+/**
+ * Quantum search parameters
+ */
+typedef struct {
+    Objective objective;  // Metric to minimize
+    sim_time_t switch_cost; // Cost added per context switch, spread over completed processes
+    sim_time_t min_quantum; // Search range (inclusive)
+    sim_time_t max_quantum;
+} OptimizerConfig;
+
+/**
+ * One simulated quantum and its metrics
+ */
+typedef struct {
+    sim_time_t quantum;
+    double objective;     // Value being minimized
+    double p99_response;  // 99th percentile response time
+    int context_switches; // Dispatches onto a CPU
+    SimSummary summary;
+} QuantumTrial;
+
+/**
+ * Outcome of one trace in batch mode
+ */
+typedef struct {
+    const char *path;     // Trace file
+    bool ok;              // Trace was loaded and simulated
+    const char *error;    // Reason when !ok
+    int process_count;    // Processes in the trace
+    sim_time_t total_time; // Simulated time
+    SimSummary summary;   // Metrics of the run
+} BatchResult;
+
+/**
+ * Work shared by the batch worker threads
+ */
+typedef struct {
+    char **paths;         // Traces to simulate
+    BatchResult *results; // One result per trace, filled by the workers
+    int trace_count;      // Number of traces
+    int next_trace;       // Next trace to hand out (guarded by lock)
+    pthread_mutex_t lock;
+    const SimConfig *config; // Shared scheduling parameters
+    int cpu_count;
+    const double *cpu_speeds;
+    sim_time_t horizon;   // Periodic release horizon (TIME_UNSET = per-trace default)
+} BatchJob;
+
+// Kernel scheduler events understood by the trace importer
+typedef enum {
+    SCHED_EVENT_SWITCH = 0,  // sched_switch: prev leaves the CPU, next takes it
+    SCHED_EVENT_WAKEUP = 1   // sched_wakeup / sched_wakeup_new: pid becomes runnable
+} SchedEventType;
+
+/**
+ * One parsed sched_switch or sched_wakeup line
+ */
+typedef struct {
+    SchedEventType type;
+    int64_t timestamp;    // Nanoseconds
+    int cpu;              // CPU the event was recorded on
+    int prev_pid;         // switch: task leaving the CPU
+    int prev_prio;
+    bool prev_runnable;   // switch: prev was preempted (state R) rather than blocked
+    int next_pid;         // switch: task taking the CPU; wakeup: task woken
+    int next_prio;
+} SchedEvent;
+
+/**
+ * Importer state of one Linux task
+ *
+ * A burst runs from the task becoming runnable to it blocking; it becomes one
+ * trace process with the CPU time the task got in between.
+ */
+typedef struct {
+    int pid;              // Linux PID (0 = empty slot)
+    int priority;         // Trace priority (KERNEL_MAX_PRIO - 1 - kernel prio)
+    int64_t arrival;      // Start of the current burst in ns (-1 = not runnable)
+    int64_t running_since; // When the task last took a CPU in ns (-1 = not running)
+    int64_t run;          // CPU time of the current burst in ns
+} ImportTask;
+
+/**
+ * Open-addressed table of the tasks seen so far, keyed by PID
+ */
+typedef struct {
+    ImportTask *slots;
+    int capacity;         // Power of two
+    int count;            // Slots in use
+} ImportTable;
+
 /************************* FUNCTION PROTOTYPES *************************/
 
 // File operations
 void load_processes(const char *filename, Process **processes_ptr, int *count);
+bool parse_process_line(const char *line, Process *p);
+void reset_process(Process *p);
+int parse_trace_buffer(const char *data, size_t length, Process *processes, int capacity);
+bool has_periodic_tasks(const Process *processes, int process_count);
+sim_time_t default_release_horizon(const Process *processes, int process_count);
+void expand_periodic_tasks(Process **processes_ptr, int *count, sim_time_t horizon);
+
+// Trace import
+bool parse_sched_event(const char *line, SchedEvent *event);
+ImportTask *find_import_task(ImportTable *table, int pid);
+void import_sched_dump(const char *dump_file, const char *output_file, int64_t tick_ns);
+
+// Simulation context
+void init_sim_context(SimContext *ctx, int process_capacity, int cpu_count, const double *cpu_speeds);
+void cleanup_sim_context(SimContext *ctx);
+sim_time_t run_simulation(SimContext *ctx, Process *processes, int process_count, const SimConfig *config);
 
 // Scheduling functions
-void simulate(Process *processes, int process_count, int cpu_count, Algorithm algorithm, int time_quantum);
-void handle_arrivals(Process *processes, int process_count, int current_time, Algorithm algorithm, 
-                    int *arrived_indices, int *arrival_count);
-void handle_rr_quantum_expiry(Process *processes, CPU *cpus, int cpu_count, int time_quantum, 
-                             ReadyQueue *ready_queue, int current_time);
-void handle_srtf_preemption(Process *processes, int process_count, CPU *cpus, int cpu_count, int current_time);
+void simulate(Process *processes, int process_count, int cpu_count, const SimConfig *config,
+              const double *cpu_speeds, OutputFormat format, const TimelineView *view);
+void order_processes_by_arrival(const Process *processes, int process_count, ArrivalKey *keys, int *order);
+void handle_arrivals(Process *processes, const int *arrival_order, int process_count, int *next_arrival,
+                    sim_time_t current_time, Algorithm algorithm, int *arrived_indices, int *arrival_count);
+void handle_rr_quantum_expiry(Process *processes, CPU *cpus, int cpu_count, sim_time_t time_quantum, 
+                             ReadyQueue *ready_queue, sim_time_t current_time);
+void handle_srtf_preemption(Process *processes, int process_count, CPU *cpus, int cpu_count,
+                            const int *cpu_order, sim_time_t *cpu_remaining, int *candidates,
+                            sim_time_t current_time);
 void assign_processes_to_idle_cpus(Process *processes, int process_count, CPU *cpus, int cpu_count, 
-                                 Algorithm algorithm, ReadyQueue *ready_queue, int current_time);
+                                 const int *cpu_order, Algorithm algorithm, ReadyQueue *ready_queue,
+                                 sim_time_t current_time);
+sim_time_t next_event_time(Process *processes, const int *arrival_order, int process_count, int next_arrival,
+                           CPU *cpus, int cpu_count, Algorithm algorithm, sim_time_t time_quantum,
+                           const GangTable *gangs, sim_time_t current_time);
 void execute_processes(Process *processes, int process_count, CPU *cpus, int cpu_count, 
-                      int current_time, int *completed_count);
-void update_waiting_times(Process *processes, int process_count, int current_time);
+                      sim_time_t current_time, sim_time_t step, int *completed_count);
+void update_waiting_times(Process *processes, int process_count, sim_time_t current_time, sim_time_t step);
+
+// Gang scheduling
+void init_gangs(GangTable *table, int process_capacity);
+bool build_gangs(GangTable *table, Process *processes, int process_count, int cpu_count);
+void cleanup_gangs(GangTable *table);
+void handle_gang_arrivals(GangTable *table, const int *arrived_indices, int arrival_count);
+void handle_gang_quantum_expiry(GangTable *table, Process *processes, CPU *cpus, int cpu_count,
+                                sim_time_t time_quantum);
+void assign_gangs_to_idle_cpus(GangTable *table, Process *processes, CPU *cpus, int cpu_count,
+                               const int *cpu_order, sim_time_t current_time);
+void account_gang_waste(GangTable *table, CPU *cpus, int cpu_count, sim_time_t step);
+void release_finished_gangs(GangTable *table, Process *processes, CPU *cpus, int cpu_count, sim_time_t step);
+
+// Real-time scheduling
+void init_job_heap(JobHeap *heap, int capacity);
+void cleanup_job_heap(JobHeap *heap);
+void push_job(JobHeap *heap, Process *processes, int process_idx, Algorithm algorithm);
+int pop_job(JobHeap *heap, Process *processes, Algorithm algorithm);
+void dispatch_realtime_jobs(Process *processes, CPU *cpus, int cpu_count, const int *cpu_order,
+                            Algorithm algorithm, JobHeap *heap, sim_time_t current_time);
+void summarize_realtime(const Process *processes, int process_count, int cpu_count, RealTimeSummary *summary);
 
 // Output and visualization
-void print_results(Process *processes, int process_count, CPU *cpus, int cpu_count, int **timeline, int total_time);
-void print_timeline(int **timeline, int total_time, Process *processes, int process_count, int cpu_count);
+void print_results(Process *processes, int process_count, CPU *cpus, int cpu_count, const Timeline *timeline,
+                   sim_time_t total_time, const GangTable *gangs, const TimelineView *view);
+void print_timeline(const Timeline *timeline, sim_time_t from, sim_time_t to, Process *processes,
+                    int process_count, int cpu_count);
+void export_timeline(const Timeline *timeline, sim_time_t from, sim_time_t to, const char *path);
 void print_process_stats(Process *processes, int process_count);
 void print_cpu_stats(CPU *cpus, int cpu_count);
-void print_average_stats(Process *processes, int process_count);
-void print_csv_output(Process *processes, int process_count, CPU *cpus, int cpu_count);
+void print_average_stats(Process *processes, int process_count, CPU *cpus, int cpu_count);
+void print_csv_output(Process *processes, int process_count, CPU *cpus, int cpu_count, const GangTable *gangs);
+void print_capacity_stats(Process *processes, int process_count, CPU *cpus, int cpu_count);
+void print_gang_stats(const GangTable *gangs, CPU *cpus, int cpu_count);
+void print_realtime_stats(const RealTimeSummary *summary);
+void summarize_results(const Process *processes, int process_count, const CPU *cpus, int cpu_count,
+                       SimSummary *summary);
+void write_csv_output(OutputBuffer *out, Process *processes, int process_count, CPU *cpus, int cpu_count,
+                      const GangTable *gangs);
+void write_json_output(OutputBuffer *out, Process *processes, int process_count, CPU *cpus, int cpu_count,
+                       const SimConfig *config, sim_time_t total_time, const GangTable *gangs);
+void write_binary_output(OutputBuffer *out, Process *processes, int process_count, CPU *cpus, int cpu_count,
+                         const SimConfig *config, sim_time_t total_time, const GangTable *gangs);
+void emit_results(OutputFormat format, Process *processes, int process_count, CPU *cpus, int cpu_count,
+                  const SimConfig *config, sim_time_t total_time, const GangTable *gangs);
+
+#ifdef SCHEDULER_PROFILE
+// Profiling
+void print_profile(FILE *stream);
+#endif
+
+// Output buffer
+void init_output_buffer(OutputBuffer *out, size_t capacity);
+void output_printf(OutputBuffer *out, const char *format, ...);
+void output_write(OutputBuffer *out, const void *bytes, size_t length);
+void flush_output_buffer(OutputBuffer *out, FILE *stream);
+void cleanup_output_buffer(OutputBuffer *out);
+
+// Quantum optimizer
+const char *objective_name(Objective objective);
+int count_context_switches(const Timeline *timeline);
+double response_percentile(const Process *processes, int process_count, sim_time_t *scratch, double percentile);
+void optimize_quantum(Process *processes, int process_count, int cpu_count, const SimConfig *config,
+                      const double *cpu_speeds, const OptimizerConfig *optimizer);
+void parse_quantum_range(const char *range, const Process *processes, int process_count, Engine engine,
+                         sim_time_t *lo, sim_time_t *hi);
+
+// Queueing models
+void fit_queueing_model(const Process *processes, int process_count, int servers, double mean_speed,
+                        QueueingEstimate *estimate);
+void print_queueing_estimates(const QueueingEstimate *estimate, const SimSummary *simulated);
+void write_queueing_csv(const QueueingEstimate *estimate);
+
+// Monte-Carlo replication
+void generate_synthetic_trace(const ReplicationJob *job, int replication, Process *processes);
+double student_t_975(int degrees_of_freedom);
+void estimate_metrics(const SimSummary *results, int count, MetricEstimate *estimates);
+void run_replications(const Process *model, int model_count, const SimConfig *config, int cpu_count,
+                      const double *cpu_speeds, int max_replications, uint64_t seed, double ci_width,
+                      int thread_count, OutputFormat format);
+
+// Batch mode
+char **list_batch_traces(const char *source, int *count);
+void run_batch(char **paths, int trace_count, const SimConfig *config, int cpu_count, const double *cpu_speeds,
+               sim_time_t horizon, int thread_count, const char *output_file);
 
 // Queue operations
-void init_queue(ReadyQueue *q);
+void init_queue(ReadyQueue *q, int capacity);
+void reset_queue(ReadyQueue *q);
+void cleanup_queue(ReadyQueue *q);
 void enqueue(ReadyQueue *q, int process_idx);
 int dequeue(ReadyQueue *q);
+int peek(const ReadyQueue *q);
 
 // Timeline management
-void init_timeline(int ***timeline_ptr, int capacity, int cpu_count);
-void expand_timeline(int ***timeline_ptr, int *capacity_ptr, int new_capacity, int cpu_count);
-void cleanup_timeline(int **timeline, int capacity);
+void init_timeline(Timeline *timeline, int64_t capacity, int cpu_count);
+void spill_timeline(Timeline *timeline, const char *directory);
+void expand_timeline(Timeline *timeline, int64_t new_capacity);
+void reset_timeline(Timeline *timeline);
+void record_timeline(Timeline *timeline, int cpu, int pid, sim_time_t start, sim_time_t end);
+void finish_timeline(Timeline *timeline);
+void seek_timeline(TimelineReader *reader, const Timeline *timeline, sim_time_t from, sim_time_t to);
+const TimelineSegment *next_timeline_segment(TimelineReader *reader);
+void close_timeline_reader(TimelineReader *reader);
+void cleanup_timeline(Timeline *timeline);
+
+// Fixed-point time
+bool parse_time(const char *text, sim_time_t *out);
+void format_time(sim_time_t t, char *buf, size_t size);
+const char *time_str(sim_time_t t);
+double time_to_double(sim_time_t t);
+
+// Heterogeneous CPU support
+double *parse_cpu_speeds(const char *speed_list, int cpu_count);
+void order_cpus_by_capacity(const CPU *cpus, int cpu_count, int *cpu_order);
+bool has_heterogeneous_cpus(const CPU *cpus, int cpu_count);
 
 // Helper functions
+void heap_sort(void *base, size_t count, size_t size, int (*compare)(const void *, const void *));
 const char* get_color_for_pid(int pid);
 const char* algorithm_name(Algorithm algorithm);
-void parse_arguments(int argc, char *argv[], Algorithm *algorithm, int *cpu_count, 
-                    int *time_quantum, char **input_file);
+void parse_arguments(int argc, char *argv[], Options *options);
 
 /************************* QUEUE OPERATIONS *************************/
 
 /**
- * Initialize a ready queue
+ * Initialize a ready queue with room for 'capacity' indices
+ */
+void init_queue(ReadyQueue *q, int capacity) {
+    q->process_indices = (int *)malloc((capacity > 0 ? capacity : 1) * sizeof(int));
+    if (!q->process_indices) {
+        perror("Failed to allocate ready queue");
+        exit(EXIT_FAILURE);
+    }
+    q->capacity = capacity > 0 ? capacity : 1;
+    reset_queue(q);
+}
+
+/**
+ * Empty a ready queue, keeping its storage
  */
-void init_queue(ReadyQueue *q) {
+void reset_queue(ReadyQueue *q) {
     q->front = 0;
     q->rear = -1;
     q->size = 0;
 }
 
+/**
+ * Release a ready queue's storage
+ */
+void cleanup_queue(ReadyQueue *q) {
+    free(q->process_indices);
+    q->process_indices = NULL;
+}
+
 /**
  * Add a process index to the ready queue
  */
 void enqueue(ReadyQueue *q, int process_idx) {
-    if (q->size >= MAX_PROCESSES) {
+    if (q->size >= q->capacity) {
         fprintf(stderr, "Error: Ready queue overflow!\n");
         return;
     }
-    q->rear = (q->rear + 1) % MAX_PROCESSES;
+    q->rear = (q->rear + 1) % q->capacity;
     q->process_indices[q->rear] = process_idx;
     q->size++;
 }
@@ -177,416 +857,1632 @@ void enqueue(ReadyQueue *q, int process_idx) {
 int dequeue(ReadyQueue *q) {
     if (q->size <= 0) return -1; // Queue empty
     int process_idx = q->process_indices[q->front];
-    q->front = (q->front + 1) % MAX_PROCESSES;
+    q->front = (q->front + 1) % q->capacity;
     q->size--;
     return process_idx;
 }
 
+/**
+ * Return the next index in the ready queue without removing it
+ * Returns -1 if queue is empty
+ */
+int peek(const ReadyQueue *q) {
+    if (q->size <= 0) return -1;
+    return q->process_indices[q->front];
+}
+
 /************************* TIMELINE MANAGEMENT *************************/
 
 /**
- * Initialize the simulation timeline data structure
+ * Initialize the simulation timeline data structure, stored in memory
  */
-void init_timeline(int ***timeline_ptr, int capacity, int cpu_count) {
-    *timeline_ptr = (int **)malloc(capacity * sizeof(int *));
-    if (!(*timeline_ptr)) {
+void init_timeline(Timeline *timeline, int64_t capacity, int cpu_count) {
+    timeline->segments = (TimelineSegment *)malloc(capacity * sizeof(TimelineSegment));
+    timeline->open = (TimelineSegment *)malloc(cpu_count * sizeof(TimelineSegment));
+    timeline->index = (sim_time_t *)malloc(INITIAL_TIMELINE_INDEX * sizeof(sim_time_t));
+    if (!timeline->segments || !timeline->open || !timeline->index) {
         perror("Failed to allocate timeline");
         exit(EXIT_FAILURE);
     }
-    
-    for (int t = 0; t < capacity; t++) {
-        (*timeline_ptr)[t] = (int *)malloc(cpu_count * sizeof(int));
-        if (!(*timeline_ptr)[t]) {
-            perror("Failed to allocate timeline row");
-            // Clean up already allocated rows
-            for (int k = 0; k < t; k++) free((*timeline_ptr)[k]);
-            free(*timeline_ptr);
-            exit(EXIT_FAILURE);
-        }
-        for (int c = 0; c < cpu_count; c++) {
-            (*timeline_ptr)[t][c] = -1; // -1 indicates idle
-        }
+    timeline->capacity = capacity;
+    timeline->window_first = 0;
+    timeline->cpu_count = cpu_count;
+    timeline->spill_fd = -1;
+    timeline->index_capacity = INITIAL_TIMELINE_INDEX;
+    reset_timeline(timeline);
+}
+
+/**
+ * Map the spill file's write window starting at segment 'first', growing the file to cover it
+ *
+ * Unmapping the previous window lets the kernel write its pages back and drop
+ * them, so only one window is ever resident.
+ */
+static void map_spill_window(Timeline *timeline, int64_t first) {
+    size_t bytes = TIMELINE_SPILL_WINDOW * sizeof(TimelineSegment);
+    if (timeline->segments) munmap(timeline->segments, bytes);
+    off_t offset = (off_t)first * (off_t)sizeof(TimelineSegment);
+    if (ftruncate(timeline->spill_fd, offset + (off_t)bytes) != 0) {
+        perror("Failed to grow timeline spill file");
+        exit(EXIT_FAILURE);
+    }
+    void *window = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, timeline->spill_fd, offset);
+    if (window == MAP_FAILED) {
+        perror("Failed to map timeline spill file");
+        exit(EXIT_FAILURE);
     }
+    timeline->segments = (TimelineSegment *)window;
+    timeline->window_first = first;
+    timeline->capacity = first + TIMELINE_SPILL_WINDOW;
 }
 
 /**
- * Expand timeline capacity when needed
+ * Keep the timeline in an unlinked file under 'directory' instead of in memory
+ *
+ * Anything recorded so far is discarded. The file disappears with the process.
+ */
+void spill_timeline(Timeline *timeline, const char *directory) {
+    if (timeline->spill_fd >= 0) return;
+
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s/scheduler-timeline-XXXXXX", directory);
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    unlink(path);
+
+    free(timeline->segments);
+    timeline->segments = NULL;
+    timeline->spill_fd = fd;
+    map_spill_window(timeline, 0);
+    reset_timeline(timeline);
+}
+
+/**
+ * Forget all recorded segments, keeping the allocated capacity
+ */
+void reset_timeline(Timeline *timeline) {
+    for (int c = 0; c < timeline->cpu_count; c++) {
+        timeline->open[c].start = TIME_UNSET;
+    }
+    timeline->count = 0;
+    timeline->index_count = 0;
+    if (timeline->spill_fd >= 0 && timeline->window_first != 0) map_spill_window(timeline, 0);
+}
+
+/**
+ * Expand in-memory timeline capacity when needed
  */
-void expand_timeline(int ***timeline_ptr, int *capacity_ptr, int new_capacity, int cpu_count) {
-    int **temp = (int **)realloc(*timeline_ptr, new_capacity * sizeof(int *));
+void expand_timeline(Timeline *timeline, int64_t new_capacity) {
+    TimelineSegment *temp = (TimelineSegment *)realloc(timeline->segments,
+                                                       new_capacity * sizeof(TimelineSegment));
     if (!temp) {
         perror("Failed to expand timeline");
         exit(EXIT_FAILURE);
     }
-    *timeline_ptr = temp;
+    timeline->segments = temp;
+    timeline->capacity = new_capacity;
+}
 
-    for (int t = *capacity_ptr; t < new_capacity; t++) {
-        (*timeline_ptr)[t] = (int *)malloc(cpu_count * sizeof(int));
-        if (!(*timeline_ptr)[t]) {
-            perror("Failed to allocate new timeline row during expansion");
-            exit(EXIT_FAILURE);
-        }
-        for (int c = 0; c < cpu_count; c++) {
-            (*timeline_ptr)[t][c] = -1;
+/**
+ * Append a closed segment to the store, indexing every TIMELINE_INDEX_STRIDE-th
+ */
+static void store_segment(Timeline *timeline, const TimelineSegment *segment) {
+    if (timeline->count >= timeline->capacity) {
+        if (timeline->spill_fd >= 0) map_spill_window(timeline, timeline->count);
+        else expand_timeline(timeline, timeline->capacity * 2);
+    }
+    if (timeline->count % TIMELINE_INDEX_STRIDE == 0) {
+        if (timeline->index_count >= timeline->index_capacity) {
+            sim_time_t *temp = (sim_time_t *)realloc(timeline->index,
+                                                     2 * timeline->index_capacity * sizeof(sim_time_t));
+            if (!temp) {
+                perror("Failed to expand timeline index");
+                exit(EXIT_FAILURE);
+            }
+            timeline->index = temp;
+            timeline->index_capacity *= 2;
         }
+        timeline->index[timeline->index_count++] = segment->end;
     }
-    *capacity_ptr = new_capacity;
+    timeline->segments[timeline->count - timeline->window_first] = *segment;
+    timeline->count++;
 }
 
 /**
- * Clean up the timeline data structure
+ * Record that 'pid' (-1 for idle) ran on 'cpu' during [start, end)
+ *
+ * Every CPU is recorded for every step, so a segment closes exactly when the
+ * step that replaces it begins and stored segments come out ordered by end.
  */
-void cleanup_timeline(int **timeline, int capacity) {
-    if (timeline) {
-        for (int t = 0; t < capacity; t++) {
-            free(timeline[t]);
-        }
-        free(timeline);
+void record_timeline(Timeline *timeline, int cpu, int pid, sim_time_t start, sim_time_t end) {
+    if (end <= start) return;
+
+    TimelineSegment *open = &timeline->open[cpu];
+    if (open->start != TIME_UNSET && open->pid == pid && open->end == start) {
+        open->end = end;
+        return;
     }
-}
 
-/************************* HELPER FUNCTIONS *************************/
+    if (open->start != TIME_UNSET) store_segment(timeline, open);
+    open->start = start;
+    open->end = end;
+    open->cpu = cpu;
+    open->pid = pid;
+}
 
 /**
- * Get a color code for a process ID for colorized output
+ * Store every CPU's unfinished segment at the end of a run
  */
-const char* get_color_for_pid(int pid) {
-    if (pid < 0) return COLOR_RESET; // Idle
-    return PROCESS_COLORS[pid % NUM_PROCESS_COLORS];
+void finish_timeline(Timeline *timeline) {
+    for (int c = 0; c < timeline->cpu_count; c++) {
+        if (timeline->open[c].start == TIME_UNSET) continue;
+        store_segment(timeline, &timeline->open[c]);
+        timeline->open[c].start = TIME_UNSET;
+    }
 }
 
 /**
- * Get the algorithm name as a string
+ * Start reading the segments that overlap [from, to)
+ *
+ * A binary search of the sparse index skips every stretch of segments that
+ * ended by 'from', so only the matching part of a spilled timeline is mapped.
  */
-const char* algorithm_name(Algorithm algorithm) {
-    switch (algorithm) {
-        case FCFS: return "First-Come, First-Served";
-        case RR:   return "Round Robin";
-        case SRTF: return "Shortest Remaining Time First";
-        case SJF:  return "Shortest Job First";
-        default:   return "Unknown Algorithm";
+void seek_timeline(TimelineReader *reader, const Timeline *timeline, sim_time_t from, sim_time_t to) {
+    int64_t lo = 0, hi = timeline->index_count; // First index entry ending after 'from'
+    while (lo < hi) {
+        int64_t mid = lo + (hi - lo) / 2;
+        if (timeline->index[mid] > from) hi = mid;
+        else lo = mid + 1;
     }
+
+    reader->timeline = timeline;
+    reader->next = lo > 0 ? (lo - 1) * TIMELINE_INDEX_STRIDE : 0;
+    reader->from = from;
+    reader->to = to;
+    reader->pending = timeline->cpu_count;
+    reader->page = NULL;
+    reader->page_first = 0;
+    reader->page_count = 0;
+    reader->mapped = false;
 }
 
 /**
- * Parse command line arguments
+ * Point the reader at the stored page holding segment 'i'
  */
-void parse_arguments(int argc, char *argv[], Algorithm *algorithm, int *cpu_count, 
-                    int *time_quantum, char **input_file) {
-    for (int i = 1; i < argc; i++) {
-        if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
-            i++;
-            if (strcmp(argv[i], "FCFS") == 0) *algorithm = FCFS;
-            else if (strcmp(argv[i], "RR") == 0) *algorithm = RR;
-            else if (strcmp(argv[i], "SRTF") == 0) *algorithm = SRTF;
-            else if (strcmp(argv[i], "SJF") == 0) *algorithm = SJF;
-            // Default is FCFS
-        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
-            *cpu_count = atoi(argv[++i]);
-            if (*cpu_count <= 0) *cpu_count = 1; // Ensure at least 1 CPU
-        } else if (strcmp(argv[i], "-q") == 0 && i + 1 < argc) {
-            *time_quantum = atoi(argv[++i]);
-            if (*time_quantum <= 0) *time_quantum = DEFAULT_TIME_QUANTUM;
-        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
-            *input_file = argv[++i];
-        } else {
-            fprintf(stderr, "Usage: %s -f <file> [-a <FCFS|RR|SRTF|SJF>] [-c <cpus>] [-q <quantum>]\n", argv[0]);
-            exit(EXIT_FAILURE);
-        }
+static void load_timeline_page(TimelineReader *reader, int64_t i) {
+    const Timeline *timeline = reader->timeline;
+    close_timeline_reader(reader);
+    if (i >= timeline->window_first) { // In memory, or the spill file's current write window
+        reader->page = timeline->segments;
+        reader->page_first = timeline->window_first;
+        reader->page_count = timeline->count - timeline->window_first;
+        return;
     }
 
-    if (!(*input_file)) {
-        fprintf(stderr, "Error: Input file required. Use -f <filename>\n");
+    int64_t first = i - i % TIMELINE_SPILL_WINDOW;
+    void *page = mmap(NULL, TIMELINE_SPILL_WINDOW * sizeof(TimelineSegment), PROT_READ, MAP_SHARED,
+                      timeline->spill_fd, (off_t)first * (off_t)sizeof(TimelineSegment));
+    if (page == MAP_FAILED) {
+        perror("Failed to map timeline spill file");
         exit(EXIT_FAILURE);
     }
+    reader->page = (const TimelineSegment *)page;
+    reader->page_first = first;
+    reader->page_count = TIMELINE_SPILL_WINDOW;
+    reader->mapped = true;
 }
 
-/************************* PROCESS LOADING *************************/
+/**
+ * Return the next segment overlapping the reader's window, or NULL when done
+ *
+ * Segments come in order of end time, not grouped by CPU.
+ */
+const TimelineSegment *next_timeline_segment(TimelineReader *reader) {
+    const Timeline *timeline = reader->timeline;
+    while (reader->pending > 0 && reader->next < timeline->count) {
+        int64_t i = reader->next++;
+        if (i < reader->page_first || i >= reader->page_first + reader->page_count) load_timeline_page(reader, i);
+        const TimelineSegment *segment = &reader->page[i - reader->page_first];
+        if (segment->start <= reader->to && reader->to < segment->end) reader->pending--;
+        if (segment->end > reader->from && segment->start < reader->to) return segment;
+    }
+    return NULL;
+}
 
 /**
- * Load processes from a file
- * 
- * Expected format:
- * <PID> <arrival_time> <burst_time> [priority]
- * 
- * Lines starting with # are treated as comments
+ * Release the page a reader has mapped, if any
  */
-void load_processes(const char *filename, Process **processes_ptr, int *count) {
-    FILE *file = fopen(filename, "r");
-    if (!file) {
-        perror("Error opening process file");
-        exit(EXIT_FAILURE);
+void close_timeline_reader(TimelineReader *reader) {
+    if (reader->mapped) munmap((void *)reader->page, TIMELINE_SPILL_WINDOW * sizeof(TimelineSegment));
+    reader->page = NULL;
+    reader->page_count = 0;
+    reader->mapped = false;
+}
+
+/**
+ * Clean up the timeline data structure
+ */
+void cleanup_timeline(Timeline *timeline) {
+    if (timeline->spill_fd >= 0) {
+        munmap(timeline->segments, TIMELINE_SPILL_WINDOW * sizeof(TimelineSegment));
+        close(timeline->spill_fd);
+    } else {
+        free(timeline->segments);
     }
+    free(timeline->open);
+    free(timeline->index);
+    timeline->segments = NULL;
+    timeline->open = NULL;
+    timeline->index = NULL;
+}
 
-    // Count valid lines first
-    int process_count = 0;
-    char line[MAX_LINE_LENGTH];
-    while (fgets(line, sizeof(line), file)) {
-        if (line[0] != '#' && line[0] != '\n' && strspn(line, " \t\n\r") != strlen(line)) {
-            int pid, arrival, burst;
-            if (sscanf(line, "%d %d %d", &pid, &arrival, &burst) == 3) {
-                process_count++;
-            }
-        }
-    }
+/************************* FIXED-POINT TIME *************************/
 
-    if (process_count == 0) {
-        *processes_ptr = NULL;
-        *count = 0;
-        fclose(file);
-        printf("Warning: No valid processes found in %s\n", filename);
-        return;
-    }
+/**
+ * Parse a non-negative decimal time in ticks (e.g. "3" or "2.25")
+ *
+ * Digits beyond the TIME_SCALE resolution are truncated. Returns false if the
+ * text is not a number or does not fit in a sim_time_t.
+ */
+bool parse_time(const char *text, sim_time_t *out) {
+    sim_time_t whole = 0, frac = 0;
+    int digits = 0, frac_digits = 0;
+    const char *cursor = text;
 
-    // Allocate memory
-    *processes_ptr = (Process *)malloc(process_count * sizeof(Process));
-    if (!(*processes_ptr)) {
-        perror("Memory allocation failed for processes");
-        fclose(file);
-        exit(EXIT_FAILURE);
+    while (isdigit((unsigned char)*cursor)) {
+        if (whole > (INT64_MAX / TIME_SCALE) / 10) return false;
+        whole = whole * 10 + (*cursor - '0');
+        cursor++;
+        digits++;
     }
-
-    // Read process data
-    rewind(file);
-    int i = 0;
-    while (fgets(line, sizeof(line), file) && i < process_count) {
-        if (line[0] == '#' || line[0] == '\n' || strspn(line, " \t\n\r") == strlen(line)) continue;
-
-        int pid, arrival, burst, priority = 0; // Default priority
-        int items_read = sscanf(line, "%d %d %d %d", &pid, &arrival, &burst, &priority);
-
-        if (items_read >= 3) { // Need at least PID, arrival, burst
-            Process *p = &(*processes_ptr)[i];
-            p->pid = pid;
-            p->arrival_time = arrival;
-            p->burst_time = burst;
-            p->priority = (items_read == 4) ? priority : 0; // Assign priority if read
-            p->remaining_time = burst;
-            p->state = WAITING;
-            p->start_time = -1;
-            p->finish_time = -1;
-            p->waiting_time = 0;
-            p->quantum_used = 0;
-            p->response_time = -1;
-            i++;
+    if (*cursor == '.') {
+        cursor++;
+        while (isdigit((unsigned char)*cursor)) {
+            if (frac_digits < TIME_DIGITS) {
+                frac = frac * 10 + (*cursor - '0');
+                frac_digits++;
+            }
+            cursor++;
+            digits++;
         }
     }
-    fclose(file);
+    if (digits == 0 || *cursor != '\0') return false;
 
-    *count = i; // Actual number of processes successfully read
-    printf("Loaded %d processes from %s\n", *count, filename);
+    for (; frac_digits < TIME_DIGITS; frac_digits++) frac *= 10;
+    *out = whole * TIME_SCALE + frac;
+    return true;
 }
 
-/************************* SIMULATION COMPONENTS *************************/
+/**
+ * Format a time in ticks into 'buf': whole ticks print as integers ("5"),
+ * fractions print without trailing zeros ("2.25")
+ *
+ * Reentrant; use this from worker threads.
+ */
+void format_time(sim_time_t t, char *buf, size_t size) {
+    const char *sign = (t < 0) ? "-" : "";
+    uint64_t magnitude = (t < 0) ? (uint64_t)(-(t + 1)) + 1 : (uint64_t)t;
+    uint64_t whole = magnitude / TIME_SCALE, frac = magnitude % TIME_SCALE;
+
+    if (frac == 0) {
+        snprintf(buf, size, "%s%" PRIu64, sign, whole);
+    } else {
+        int len = snprintf(buf, size, "%s%" PRIu64 ".%0*" PRIu64, sign, whole, TIME_DIGITS, frac);
+        if (len >= (int)size) len = (int)size - 1;
+        while (len > 0 && buf[len - 1] == '0') buf[--len] = '\0';
+    }
+}
 
 /**
- * Handle process arrivals at the current time
+ * Format a time like format_time() into one of TIME_STR_SLOTS rotating static
+ * buffers, so several calls may appear in one printf, but the result must be
+ * used before that many more calls.
+ *
+ * Not thread-safe: the buffers are shared by all threads. Worker threads must
+ * use format_time() with a buffer of their own.
  */
-void handle_arrivals(Process *processes, int process_count, int current_time, Algorithm algorithm, 
-                   int *arrived_indices, int *arrival_count) {
-    // DONE: Implement process arrival handling
-    // 
-    // This function should:
-    // 1. Set *arrival_count to 0
-    // 2. Check all processes to find any that arrived at 'current_time'
-    // 3. For RR and SRTF algorithms, mark these processes as READY
-    // 4. For all algorithms, add the indices of newly arrived processes to arrived_indices[]
-    // 5. Increment *arrival_count for each arrived process
-    //
-    // Hint: processes[i].arrival_time == current_time indicates a process has just arrived
-	
-    *arrival_count = 0; // Initialize arrival count
+const char *time_str(sim_time_t t) {
+    static char buffers[TIME_STR_SLOTS][TIME_STR_LENGTH];
+    static int next_buffer = 0;
+    char *buf = buffers[next_buffer];
+    next_buffer = (next_buffer + 1) % TIME_STR_SLOTS;
 
-	for (int i = 0; i < process_count; i++) {
-		if (processes[i].arrival_time == current_time) {
-			if (algorithm == RR || algorithm == SRTF) {
-				processes[i].state = READY;
-			}							
-			arrived_indices[*arrival_count] = i;
-			(*arrival_count)++;
-		}
-	}
+    format_time(t, buf, sizeof(buffers[0]));
+    return buf;
 }
 
 /**
- * Handle quantum expiration for Round Robin scheduling
+ * Convert a time to (possibly fractional) ticks for averaging and ratios
  */
-void handle_rr_quantum_expiry(Process *processes, CPU *cpus, int cpu_count, int time_quantum, 
-                           ReadyQueue *ready_queue, int current_time) {
-    // DONE: Implement the Round Robin quantum expiration logic
-    //
-    // This function should:
-    // 1. Check all CPUs for processes that have used up their time quantum
-    // 2. For processes that have used up their quantum:
-    //    - Change their state to READY
-    //    - Remove them from their CPU (set CPU's current_process to NULL)
-    //    - Add them to the ready_queue
-    // 3. A process has used up its quantum when its quantum_used >= time_quantum
-    //
-    // Note: The current_time parameter is not used but kept for API consistency
-    (void)current_time; // Explicitly mark as unused
-	(void)processes; // TODO should this be used?
+double time_to_double(sim_time_t t) {
+    return (double)t / TIME_SCALE;
+}
 
-	for (int i = 0; i < cpu_count; i++) {
-		Process *process = cpus[i].current_process;
+/************************* PROFILING *************************/
 
-		if (process != NULL && process->quantum_used >= time_quantum) {
-			process->state = READY;
-			cpus[i].current_process = NULL;	
-            enqueue(ready_queue, process->pid);
-		}
-	}
+#ifdef SCHEDULER_PROFILE
+static __thread Profile profile; // Per thread, so batch and replication workers do not race
+
+static const char *PHASE_NAMES[PHASE_COUNT] = {
+    "arrivals", "quantum expiry", "srtf preemption", "assignment",
+    "next event", "timeline write", "waiting update", "execute"
+};
+
+static uint64_t profile_clock(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
 }
 
+static void profile_record(ProfilePhase phase, uint64_t start) {
+    profile.phases[phase].calls++;
+    profile.phases[phase].nanoseconds += profile_clock() - start;
+}
 
 /**
- * Implement preemptive scheduling for SRTF
+ * Print the profile of the last simulation on this thread
+ *
+ * Times include the clock reads themselves (tens of nanoseconds per phase),
+ * so compare phases against each other rather than against unprofiled runs.
  */
-void handle_srtf_preemption(Process *processes, int process_count, CPU *cpus, int cpu_count, int current_time) {
-    // DONE: Implement Shortest Remaining Time First preemptive logic
-    //
-    // This function should:
-    // 1. Find the process with the shortest remaining time that's ready to run
-    //    (not completed, not running, and has arrived by current_time)
-    // 2. If multiple processes tie for shortest time, prioritize by priority value
-    // 3. For each CPU, check if its running process should be preempted:
-    //    - If the shortest ready process has less remaining time than 
-    //      a currently running process, preempt the running process
-    //    - When preempting, consider preempting the running process with lowest priority
-    // 4. When a preemption occurs:
-    //    - Change preempted process state to WAITING
-    //    - Change new process state to RUNNING
-    //    - Update CPU's current_process pointer
-    //    - Set start_time and response_time for the new process if this is its first run
-    //
-    // Hint: You may need to repeat this until no more preemptions occur
+void print_profile(FILE *stream) {
+    uint64_t total = 0;
+    for (int p = 0; p < PHASE_COUNT; p++) total += profile.phases[p].nanoseconds;
+    double steps = profile.steps > 0 ? (double)profile.steps : 1.0;
 
-	CPU *preempt_cpu = NULL;
+    fprintf(stream, "\nSimulation Profile (%" PRIu64 " steps):\n", profile.steps);
+    fprintf(stream, "%-16s %10s %11s %6s %9s %12s %11s\n", "Phase", "Calls", "Time (ms)", "Share",
+            "ns/call", "Scans/step", "Cmps/step");
+    fprintf(stream, "-------------------------------------------------------------------------------\n");
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        const PhaseProfile *phase = &profile.phases[p];
+        if (phase->calls == 0) continue;
+        fprintf(stream, "%-16s %10" PRIu64 " %11.3f %5.1f%% %9.1f %12.2f %11.2f\n", PHASE_NAMES[p],
+                phase->calls, phase->nanoseconds / 1e6, total > 0 ? 100.0 * phase->nanoseconds / total : 0.0,
+                (double)phase->nanoseconds / phase->calls, phase->scans / steps, phase->comparisons / steps);
+    }
+    fprintf(stream, "%-16s %10s %11.3f\n", "total", "", total / 1e6);
+}
+#endif
 
-	do {
-		// Decide which process is ready to run next
-		Process *min_process = NULL;
-		for (int i = 0; i < process_count; i++) {
-			Process *process = &processes[i];
+/************************* OUTPUT BUFFER *************************/
 
-			if (process->arrival_time <= current_time 
-				&& process->state == READY 
-				&& (min_process == NULL 
-					|| process->remaining_time < min_process->remaining_time
-					|| (process->remaining_time == min_process->remaining_time 
-						&& process->priority > min_process->priority))) {
-				min_process = process;
-			} 		
-		}
+/**
+ * Initialize an output buffer with room for 'capacity' bytes
+ */
+void init_output_buffer(OutputBuffer *out, size_t capacity) {
+    out->capacity = capacity > 0 ? capacity : 1;
+    out->data = (char *)malloc(out->capacity);
+    if (!out->data) {
+        perror("Failed to allocate output buffer");
+        exit(EXIT_FAILURE);
+    }
+    out->length = 0;
+}
 
-		if (min_process == NULL) {
-			break;  // We can't preempt if there's no processes to run
-		}
+/**
+ * Make room for at least 'extra' more bytes, doubling the capacity
+ */
+static void reserve_output(OutputBuffer *out, size_t extra) {
+    if (out->length + extra <= out->capacity) return;
+    size_t capacity = out->capacity;
+    while (out->length + extra > capacity) capacity *= 2;
+    char *grown = (char *)realloc(out->data, capacity);
+    if (!grown) {
+        perror("Failed to grow output buffer");
+        exit(EXIT_FAILURE);
+    }
+    out->data = grown;
+    out->capacity = capacity;
+}
 
-		// Decide which CPU is ready to kick out its process
-		preempt_cpu = NULL;
+/**
+ * Append printf-formatted text
+ */
+void output_printf(OutputBuffer *out, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    size_t room = out->capacity - out->length;
+    int needed = vsnprintf(out->data + out->length, room, format, args);
+    va_end(args);
+    if (needed < 0) return;
 
-		for (int i = 0; i < cpu_count; i++) {
-			Process *curr_process = cpus[i].current_process;  
-			
-			if (curr_process == NULL 
-				|| (min_process->remaining_time < curr_process->remaining_time 
-				&& (preempt_cpu == NULL 
-					|| preempt_cpu->current_process->priority < curr_process->priority))) {
+    if ((size_t)needed >= room) {
+        reserve_output(out, (size_t)needed + 1);
+        va_start(args, format);
+        vsnprintf(out->data + out->length, out->capacity - out->length, format, args);
+        va_end(args);
+    }
+    out->length += (size_t)needed;
+}
 
-				preempt_cpu = &cpus[i];
+/**
+ * Append raw bytes
+ */
+void output_write(OutputBuffer *out, const void *bytes, size_t length) {
+    reserve_output(out, length);
+    memcpy(out->data + out->length, bytes, length);
+    out->length += length;
+}
 
-				// Perform preemption
-				if (curr_process != NULL) {
-					preempt_cpu->current_process->state = WAITING;	
-				}
-				min_process->state = RUNNING;
-				preempt_cpu->current_process = min_process;
+/**
+ * Write everything buffered to 'stream' in one call and empty the buffer
+ */
+void flush_output_buffer(OutputBuffer *out, FILE *stream) {
+    if (out->length > 0 && fwrite(out->data, 1, out->length, stream) != out->length) {
+        perror("Failed to write output");
+        exit(EXIT_FAILURE);
+    }
+    fflush(stream);
+    out->length = 0;
+}
 
-				if (min_process->start_time == -1) {
-					min_process->start_time = current_time;
-					min_process->response_time = current_time - min_process->arrival_time;
-				}
-				break;
-			}
-		}
-	} while (preempt_cpu != NULL);
+/**
+ * Release an output buffer
+ */
+void cleanup_output_buffer(OutputBuffer *out) {
+    free(out->data);
+    out->data = NULL;
 }
 
-Process *tie_breaker(Process *p1, Process *p2) {
-	if (p1->priority > p2->priority) {
-		return p1;
-	} else if (p2->priority > p1->priority) {
-		return p2;
-	} else if (p1->arrival_time < p2->arrival_time) {
-		return p1;
-	} else if (p2->arrival_time < p1->arrival_time) {
-		return p2;
-	} else {
-		return p1;
-	}
+/************************* HELPER FUNCTIONS *************************/
+
+/**
+ * Swap two 'size'-byte elements
+ */
+static void swap_elements(unsigned char *a, unsigned char *b, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        unsigned char tmp = a[i];
+        a[i] = b[i];
+        b[i] = tmp;
+    }
 }
 
 /**
- * Assign processes to idle CPUs based on the current scheduling algorithm
+ * Restore the max-heap property below 'root' within the first 'end' elements
  */
-void assign_processes_to_idle_cpus(Process *processes, int process_count, CPU *cpus, int cpu_count, 
-                                Algorithm algorithm, ReadyQueue *ready_queue, int current_time) {
-    // TODO: Implement process assignment to idle CPUs for all scheduling algorithms
-    //
-    // This function should:
-    // 1. For each idle CPU (where current_process is NULL):
-    //    a. Find the next process to run based on the scheduling algorithm:
-    //       - FCFS: Select process with earliest arrival time that is waiting
-    //       - RR: Take the next process from the ready_queue
-    //       - SJF: Select waiting process with shortest burst_time
-    //       - SRTF: Select waiting process with shortest remaining_time
-    //    b. If multiple processes tie in selection criteria, prioritize by:
-    //       - Higher priority value first
-    //       - Earlier arrival time second
-    // 2. For the selected process:
-    //    - Change state to RUNNING
-    //    - Assign it to the CPU
-    //    - Reset its quantum_used (for RR)
-    //    - Update start_time and response_time if this is first execution
-    //
-    // TODO Hint: Use a boolean array to track which processes are scheduled in this time step
-    //       to avoid scheduling the same process on multiple CPUs
+static void sift_down(unsigned char *bytes, size_t root, size_t end, size_t size,
+                      int (*compare)(const void *, const void *)) {
+    for (;;) {
+        size_t child = 2 * root + 1;
+        if (child >= end) return;
+        if (child + 1 < end && compare(bytes + child * size, bytes + (child + 1) * size) < 0) child++;
+        if (compare(bytes + root * size, bytes + child * size) >= 0) return;
+        swap_elements(bytes + root * size, bytes + child * size, size);
+        root = child;
+    }
+}
 
-	bool scheduled[process_count];
-	for (int i = 0; i < process_count; i++) {
-		scheduled[i] = 0;
-	}
+/**
+ * In-place heap sort with the same interface as qsort()
+ *
+ * Unlike qsort() it never allocates, so it is safe on the simulation path.
+ * It is not stable; callers sort keys that are unique.
+ */
+void heap_sort(void *base, size_t count, size_t size, int (*compare)(const void *, const void *)) {
+    unsigned char *bytes = (unsigned char *)base;
 
-	for (int i = 0; i < cpu_count; i++) {
-		Process *new_process = NULL;  // try and find the next process to run
+    for (size_t start = count / 2; start > 0; start--) {
+        sift_down(bytes, start - 1, count, size, compare);
+    }
+    for (size_t end = count; end > 1; end--) {
+        swap_elements(bytes, bytes + (end - 1) * size, size);
+        sift_down(bytes, 0, end - 1, size, compare);
+    }
+}
 
-		if (cpus[i].current_process != NULL) {
-			continue;  // we only care about idle CPUS
-		}
-		
-		if (algorithm == RR) {
-			// Round robin just runs the next process in the queue
-			int idx = dequeue(ready_queue);
+/**
+ * Get a color code for a process ID for colorized output
+ */
+const char* get_color_for_pid(int pid) {
+    if (pid < 0) return COLOR_RESET; // Idle
+    return PROCESS_COLORS[pid % NUM_PROCESS_COLORS];
+}
 
-			if (idx > -1) {
-				new_process = &processes[idx];	
-				new_process->quantum_used = 0;
-			} else {
-				break;
-			}
-		} 
+/**
+ * Get the algorithm name as a string
+ */
+const char* algorithm_name(Algorithm algorithm) {
+    switch (algorithm) {
+        case FCFS: return "First-Come, First-Served";
+        case RR:   return "Round Robin";
+        case SRTF: return "Shortest Remaining Time First";
+        case SJF:  return "Shortest Job First";
+        case GANG: return "Gang Scheduling";
+        case EDF:  return "Earliest Deadline First";
+        case RM:   return "Rate Monotonic";
+        default:   return "Unknown Algorithm";
+    }
+}
 
-		// All other algorithms we need to check all processes
-		for (int i = 0; i < process_count; i++) {
-			if (scheduled[i] // NOTE do we need this?
-				|| processes[i].state != WAITING 
-				|| processes[i].arrival_time > current_time) {
-				// we only want to look at unscheduled,  waiting processes that have arrived
-			} else if (new_process == NULL) {
-				new_process = &processes[i];
-				continue;
+/**
+ * Parse command line arguments
+ */
+void parse_arguments(int argc, char *argv[], Options *options) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "FCFS") == 0) options->algorithm = FCFS;
+            else if (strcmp(argv[i], "RR") == 0) options->algorithm = RR;
+            else if (strcmp(argv[i], "SRTF") == 0) options->algorithm = SRTF;
+            else if (strcmp(argv[i], "SJF") == 0) options->algorithm = SJF;
+            else if (strcmp(argv[i], "GANG") == 0) options->algorithm = GANG;
+            else if (strcmp(argv[i], "EDF") == 0) options->algorithm = EDF;
+            else if (strcmp(argv[i], "RM") == 0) options->algorithm = RM;
+            // Default is FCFS
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            options->cpu_count = atoi(argv[++i]);
+            if (options->cpu_count <= 0) options->cpu_count = 1; // Ensure at least 1 CPU
+        } else if (strcmp(argv[i], "-q") == 0 && i + 1 < argc) {
+            if (!parse_time(argv[++i], &options->time_quantum) || options->time_quantum <= 0) {
+                options->time_quantum = TICKS(DEFAULT_TIME_QUANTUM);
+            }
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            options->input_file = argv[++i];
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            options->speed_list = argv[++i];
+        } else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "tick") == 0) options->engine = ENGINE_TICK;
+            else if (strcmp(argv[i], "event") == 0) options->engine = ENGINE_EVENT;
+            // Default is event
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            options->batch_source = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            options->output_file = argv[++i];
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            options->thread_count = atoi(argv[++i]);
+            if (options->thread_count < 0) options->thread_count = 0; // Auto
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "text") == 0) options->format = FORMAT_TEXT;
+            else if (strcmp(argv[i], "csv") == 0) options->format = FORMAT_CSV;
+            else if (strcmp(argv[i], "json") == 0) options->format = FORMAT_JSON;
+            else if (strcmp(argv[i], "binary") == 0) options->format = FORMAT_BINARY;
+            else {
+                fprintf(stderr, "Error: Unknown format '%s' (expected text, csv, json or binary)\n", argv[i]);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--optimize") == 0 && i + 1 < argc) {
+            i++;
+            options->optimize = true;
+            if (strcmp(argv[i], "response") == 0) options->objective = OBJECTIVE_RESPONSE;
+            else if (strcmp(argv[i], "p99") == 0) options->objective = OBJECTIVE_P99;
+            else if (strcmp(argv[i], "turnaround") == 0) options->objective = OBJECTIVE_TURNAROUND;
+            else if (strcmp(argv[i], "waiting") == 0) options->objective = OBJECTIVE_WAITING;
+            else {
+                fprintf(stderr, "Error: Unknown objective '%s' (expected response, p99, turnaround or waiting)\n",
+                        argv[i]);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--switch-cost") == 0 && i + 1 < argc) {
+            if (!parse_time(argv[++i], &options->switch_cost) || options->switch_cost < 0) {
+                fprintf(stderr, "Error: Invalid switch cost '%s'\n", argv[i]);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--quantum-range") == 0 && i + 1 < argc) {
+            options->quantum_range = argv[++i];
+        } else if (strcmp(argv[i], "--replicate") == 0 && i + 1 < argc) {
+            options->replications = atoi(argv[++i]);
+            if (options->replications <= 0) {
+                fprintf(stderr, "Error: Invalid replication count '%s'\n", argv[i]);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options->seed = strtoull(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--ci-width") == 0 && i + 1 < argc) {
+            options->ci_width = atof(argv[++i]);
+            if (options->ci_width < 0.0) options->ci_width = 0.0;
+        } else if (strcmp(argv[i], "--estimate") == 0) {
+            options->estimate = true;
+        } else if (strcmp(argv[i], "--horizon") == 0 && i + 1 < argc) {
+            if (!parse_time(argv[++i], &options->horizon) || options->horizon <= 0) {
+                fprintf(stderr, "Error: Invalid horizon '%s'\n", argv[i]);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--spill") == 0 && i + 1 < argc) {
+            options->spill_dir = argv[++i];
+        } else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc) {
+            char from_text[MAX_LINE_LENGTH], to_text[MAX_LINE_LENGTH];
+            i++;
+            if (sscanf(argv[i], "%255[^,],%255s", from_text, to_text) != 2 ||
+                !parse_time(from_text, &options->window_from) || !parse_time(to_text, &options->window_to) ||
+                options->window_from < 0 || options->window_to <= options->window_from) {
+                fprintf(stderr, "Error: Invalid window '%s' (expected from,to with 0 <= from < to)\n", argv[i]);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--export-timeline") == 0 && i + 1 < argc) {
+            options->export_timeline = argv[++i];
+        } else if (strcmp(argv[i], "--import") == 0 && i + 1 < argc) {
+            options->import_file = argv[++i];
+        } else if (strcmp(argv[i], "--tick-us") == 0 && i + 1 < argc) {
+            double tick_us = atof(argv[++i]);
+            options->tick_ns = (int64_t)(tick_us * 1000.0 + 0.5);
+            if (options->tick_ns <= 0) {
+                fprintf(stderr, "Error: Invalid tick length '%s' (microseconds)\n", argv[i]);
+                exit(EXIT_FAILURE);
+            }
+        } else {
+            fprintf(stderr, "Usage: %s -f <file> [-a <FCFS|RR|SRTF|SJF|GANG|EDF|RM>] [-c <cpus>] [-q <quantum>]"
+                            " [-s <speed,speed,...>] [-e <event|tick>] [--format <text|csv|json|binary>]"
+                            " [--horizon <time>]\n"
+                            "           [--spill <dir>] [--window <from,to>] [--export-timeline <file.csv>]\n"
+                            "       %s -b <dir|manifest> [-o <results.csv>] [-j <threads>] [scheduling options]\n"
+                            "       %s -f <file> -a <RR|GANG> --optimize <response|p99|turnaround|waiting>"
+                            " [--switch-cost <time>] [--quantum-range <lo,hi>] [scheduling options]\n"
+                            "       %s -f <file> --replicate <n> [--seed <s>] [--ci-width <ticks>] [-j <threads>]"
+                            " [scheduling options]\n"
+                            "       %s -f <file> --estimate [-c <cpus>] [-s <speeds>] [--format <text|csv>]\n"
+                            "       %s --import <perf-sched-or-ftrace.txt> [-o <trace.txt>] [--tick-us <us>]\n",
+                    argv[0], argv[0], argv[0], argv[0], argv[0], argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (!options->input_file && !options->batch_source && !options->import_file) {
+        fprintf(stderr, "Error: Input file required. Use -f <filename> (or -b <dir|manifest> for batch mode)\n");
+        exit(EXIT_FAILURE);
+    }
+    if (options->optimize && options->algorithm != RR && options->algorithm != GANG) {
+        fprintf(stderr, "Error: --optimize searches the time quantum; use it with -a RR or -a GANG\n");
+        exit(EXIT_FAILURE);
+    }
+    if (options->replications > 0 && options->format == FORMAT_BINARY) {
+        fprintf(stderr, "Error: --replicate reports in text, csv or json\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/************************* HETEROGENEOUS CPUS *************************/
+
+/**
+ * Parse a comma-separated list of per-CPU speed factors (e.g. "2,2,1,1")
+ *
+ * CPUs without an entry run at DEFAULT_CPU_SPEED. Returns a malloc'd array
+ * of cpu_count speeds; the caller frees it.
+ */
+double *parse_cpu_speeds(const char *speed_list, int cpu_count) {
+    double *speeds = (double *)malloc(cpu_count * sizeof(double));
+    if (!speeds) {
+        perror("Failed to allocate CPU speeds");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c < cpu_count; c++) speeds[c] = DEFAULT_CPU_SPEED;
+    if (!speed_list) return speeds;
+
+    const char *cursor = speed_list;
+    for (int c = 0; *cursor != '\0'; c++) {
+        char *end = NULL;
+        double speed = strtod(cursor, &end);
+        if (end == cursor || speed <= 0.0 || (*end != ',' && *end != '\0')) {
+            fprintf(stderr, "Error: Invalid CPU speed list '%s' (expected positive numbers, e.g. 2,1,1)\n",
+                    speed_list);
+            exit(EXIT_FAILURE);
+        }
+        if (c >= cpu_count) {
+            fprintf(stderr, "Error: %d CPU speeds given for %d CPU(s)\n", c + 1, cpu_count);
+            exit(EXIT_FAILURE);
+        }
+        speeds[c] = speed;
+        cursor = (*end == ',') ? end + 1 : end;
+    }
+    return speeds;
+}
+
+/**
+ * Fill cpu_order with CPU indices sorted fastest first (ties keep CPU id order)
+ *
+ * Placement walks CPUs in this order, so the job picked first by the policy
+ * lands on the biggest idle core. With uniform speeds the order is 0..n-1.
+ */
+void order_cpus_by_capacity(const CPU *cpus, int cpu_count, int *cpu_order) {
+    for (int i = 0; i < cpu_count; i++) {
+        int j = i;
+        while (j > 0 && cpus[cpu_order[j - 1]].speed < cpus[i].speed) {
+            cpu_order[j] = cpu_order[j - 1];
+            j--;
+        }
+        cpu_order[j] = i;
+    }
+}
+
+/**
+ * Check whether any CPU runs at a non-baseline speed
+ */
+bool has_heterogeneous_cpus(const CPU *cpus, int cpu_count) {
+    for (int c = 0; c < cpu_count; c++) {
+        if (cpus[c].speed != DEFAULT_CPU_SPEED) return true;
+    }
+    return false;
+}
+
+/************************* PROCESS LOADING *************************/
+
+/**
+ * Parse one trace line into a freshly initialized process
+ *
+ * Returns false for comments, blank lines and malformed entries.
+ */
+bool parse_process_line(const char *line, Process *p) {
+    if (line[0] == '#' || line[0] == '\n' || strspn(line, " \t\n\r") == strlen(line)) return false;
+
+    int pid, priority = 0, group_id = -1; // Default priority, ungrouped
+    char arrival[MAX_LINE_LENGTH], burst[MAX_LINE_LENGTH], deadline[MAX_LINE_LENGTH], period[MAX_LINE_LENGTH];
+    int items_read = sscanf(line, "%d %255s %255s %d %d %255s %255s",
+                            &pid, arrival, burst, &priority, &group_id, deadline, period);
+    if (items_read < 3) return false; // Need at least PID, arrival, burst
+
+    sim_time_t arrival_time, burst_time;
+    if (!parse_time(arrival, &arrival_time) || !parse_time(burst, &burst_time)) return false;
+
+    // Optional real-time columns: relative deadline and period (0 = none)
+    sim_time_t relative_deadline = 0, release_period = 0;
+    if (items_read >= 6 && (!parse_time(deadline, &relative_deadline) || relative_deadline < 0)) return false;
+    if (items_read == 7 && (!parse_time(period, &release_period) || release_period < 0)) return false;
+    if (relative_deadline == 0) relative_deadline = release_period; // Implicit deadline = period
+
+    p->pid = pid;
+    p->arrival_time = arrival_time;
+    p->burst_time = burst_time;
+    p->priority = (items_read >= 4) ? priority : 0; // Assign priority if read
+    p->group_id = (items_read >= 5) ? group_id : -1;
+    p->deadline = (relative_deadline > 0) ? arrival_time + relative_deadline : TIME_UNSET;
+    p->period = release_period;
+    p->job = 0;
+    reset_process(p);
+    return true;
+}
+
+/**
+ * Clear a process's run-time state so the trace can be simulated again
+ */
+void reset_process(Process *p) {
+    p->remaining_time = p->burst_time;
+    p->state = WAITING;
+    p->start_time = TIME_UNSET;
+    p->finish_time = TIME_UNSET;
+    p->waiting_time = 0;
+    p->quantum_used = 0;
+    p->response_time = TIME_UNSET;
+}
+
+/**
+ * Load processes from a file
+ * 
+ * Expected format:
+ * <PID> <arrival_time> <burst_time> [priority] [group_id] [deadline] [period]
+ * 
+ * Arrival and burst times are in ticks and may be fractional (e.g. 2.5).
+ * Processes sharing a group_id form a gang for GANG scheduling (-1 = none).
+ * The deadline is relative to arrival; a non-zero period makes the line a
+ * periodic task (see expand_periodic_tasks), whose deadline defaults to its period.
+ * Lines starting with # are treated as comments
+ */
+void load_processes(const char *filename, Process **processes_ptr, int *count) {
+    FILE *file = fopen(filename, "r");
+    if (!file) {
+        perror("Error opening process file");
+        exit(EXIT_FAILURE);
+    }
+
+    // Count valid lines first
+    int process_count = 0;
+    char line[MAX_LINE_LENGTH];
+    Process scratch;
+    while (fgets(line, sizeof(line), file)) {
+        if (parse_process_line(line, &scratch)) {
+            process_count++;
+        }
+    }
+
+    if (process_count == 0) {
+        *processes_ptr = NULL;
+        *count = 0;
+        fclose(file);
+        return;
+    }
+
+    // Allocate memory
+    *processes_ptr = (Process *)malloc(process_count * sizeof(Process));
+    if (!(*processes_ptr)) {
+        perror("Memory allocation failed for processes");
+        fclose(file);
+        exit(EXIT_FAILURE);
+    }
+
+    // Read process data
+    rewind(file);
+    int i = 0;
+    while (fgets(line, sizeof(line), file) && i < process_count) {
+        if (parse_process_line(line, &(*processes_ptr)[i])) {
+            i++;
+        }
+    }
+    fclose(file);
+
+    *count = i; // Actual number of processes successfully read
+}
+
+/**
+ * Parse a trace held in memory (e.g. a mapped file) and return its process count
+ *
+ * Processes are stored while they fit in 'capacity'; pass NULL to only count.
+ * Lines longer than MAX_LINE_LENGTH are truncated, as with fgets().
+ */
+int parse_trace_buffer(const char *data, size_t length, Process *processes, int capacity) {
+    char line[MAX_LINE_LENGTH];
+    Process scratch;
+    int count = 0;
+    size_t pos = 0;
+
+    while (pos < length) {
+        const char *start = data + pos;
+        const char *newline = memchr(start, '\n', length - pos);
+        size_t line_length = newline ? (size_t)(newline - start) + 1 : length - pos;
+        size_t copy = line_length < sizeof(line) - 1 ? line_length : sizeof(line) - 1;
+        memcpy(line, start, copy);
+        line[copy] = '\0';
+        pos += line_length;
+
+        Process *p = (processes && count < capacity) ? &processes[count] : &scratch;
+        if (parse_process_line(line, p)) count++;
+    }
+    return count;
+}
+
+/**
+ * Check whether any process is a periodic task
+ */
+bool has_periodic_tasks(const Process *processes, int process_count) {
+    for (int i = 0; i < process_count; i++) {
+        if (processes[i].period > 0) return true;
+    }
+    return false;
+}
+
+static sim_time_t gcd_time(sim_time_t a, sim_time_t b) {
+    while (b != 0) {
+        sim_time_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+/**
+ * Default horizon for periodic releases: latest first release plus one hyperperiod
+ *
+ * The hyperperiod is capped at DEFAULT_HORIZON_PERIODS longest periods so
+ * co-prime periods cannot blow up the number of jobs.
+ */
+sim_time_t default_release_horizon(const Process *processes, int process_count) {
+    sim_time_t hyperperiod = 1, longest = 0, latest = 0;
+    bool capped = false;
+
+    for (int i = 0; i < process_count; i++) {
+        if (processes[i].period <= 0) continue;
+        if (processes[i].period > longest) longest = processes[i].period;
+        if (processes[i].arrival_time > latest) latest = processes[i].arrival_time;
+    }
+    sim_time_t cap = (longest > INT64_MAX / DEFAULT_HORIZON_PERIODS) ? INT64_MAX : longest * DEFAULT_HORIZON_PERIODS;
+
+    for (int i = 0; i < process_count && !capped; i++) {
+        sim_time_t period = processes[i].period;
+        if (period <= 0) continue;
+        sim_time_t factor = period / gcd_time(hyperperiod, period);
+        if (hyperperiod > cap / factor) capped = true;
+        else hyperperiod *= factor;
+    }
+    if (capped) {
+        char cap_text[TIME_STR_LENGTH]; // Batch workers get here concurrently; time_str() is not thread-safe
+        format_time(cap, cap_text, sizeof(cap_text));
+        fprintf(stderr, "Warning: Hyperperiod exceeds %d periods; releasing jobs for %s ticks (use --horizon)\n",
+                DEFAULT_HORIZON_PERIODS, cap_text);
+        hyperperiod = cap;
+    }
+    return latest + hyperperiod;
+}
+
+/**
+ * Replace each periodic task by its job releases before 'horizon'
+ *
+ * Job k of a task with period T arrives at arrival + k*T with the task's
+ * relative deadline and keeps the task's pid, burst and priority. One-shot
+ * processes are kept as they are. The array is reallocated; trace order is kept.
+ */
+void expand_periodic_tasks(Process **processes_ptr, int *count, sim_time_t horizon) {
+    Process *tasks = *processes_ptr;
+    long long total = 0;
+    for (int i = 0; i < *count; i++) {
+        const Process *task = &tasks[i];
+        if (task->period <= 0) total++;
+        else if (task->arrival_time < horizon) total += (horizon - task->arrival_time - 1) / task->period + 1;
+    }
+    if (total > INT_MAX) {
+        fprintf(stderr, "Error: %lld job releases before the horizon; use a shorter --horizon\n", total);
+        exit(EXIT_FAILURE);
+    }
+
+    Process *jobs = (Process *)malloc((total > 0 ? total : 1) * sizeof(Process));
+    if (!jobs) {
+        perror("Failed to allocate periodic jobs");
+        exit(EXIT_FAILURE);
+    }
+
+    int n = 0;
+    for (int i = 0; i < *count; i++) {
+        const Process *task = &tasks[i];
+        if (task->period <= 0) {
+            jobs[n++] = *task;
+            continue;
+        }
+        sim_time_t relative_deadline = task->deadline - task->arrival_time;
+        int k = 0;
+        for (sim_time_t release = task->arrival_time; release < horizon; release += task->period, k++) {
+            Process *job = &jobs[n++];
+            *job = *task;
+            job->arrival_time = release;
+            job->deadline = release + relative_deadline;
+            job->job = k;
+        }
+    }
+
+    free(tasks);
+    *processes_ptr = jobs;
+    *count = n;
+}
+
+/************************* TRACE IMPORT *************************/
+
+/**
+ * Find "key=" in 'text' as a whole field and return its value
+ */
+static const char *find_field(const char *text, const char *key) {
+    size_t length = strlen(key);
+    for (const char *at = strstr(text, key); at; at = strstr(at + 1, key)) {
+        if ((at == text || at[-1] == ' ') && at[length] == '=') return at + length + 1;
+    }
+    return NULL;
+}
+
+static bool field_int(const char *text, const char *key, int *out) {
+    const char *value = find_field(text, key);
+    if (!value) return false;
+    char *end;
+    long parsed = strtol(value, &end, 10);
+    if (end == value) return false;
+    *out = (int)parsed;
+    return true;
+}
+
+/**
+ * Parse a "seconds.fraction" timestamp ending at 'end' into nanoseconds
+ */
+static bool parse_timestamp(const char *text, const char *end, int64_t *ns) {
+    int64_t seconds = 0, fraction = 0;
+    int digits = 0;
+    bool dot = false;
+    for (const char *c = text; c < end; c++) {
+        if (*c == '.' && !dot) {
+            dot = true;
+        } else if (!isdigit((unsigned char)*c)) {
+            return false;
+        } else if (!dot) {
+            seconds = seconds * 10 + (*c - '0');
+        } else if (digits < 9) {
+            fraction = fraction * 10 + (*c - '0');
+            digits++;
+        }
+    }
+    if (!dot || digits == 0) return false;
+    for (; digits < 9; digits++) fraction *= 10;
+    *ns = seconds * 1000000000 + fraction;
+    return true;
+}
+
+/**
+ * Parse perf's compact "comm:pid [prio]" task before 'end'; *after points past the ']'
+ */
+static bool parse_compact_task(const char *text, const char *end, int *pid, int *prio, const char **after) {
+    const char *bracket = text;
+    while (bracket + 1 < end && !(bracket[0] == ' ' && bracket[1] == '[' && isdigit((unsigned char)bracket[2]))) {
+        bracket++;
+    }
+    if (bracket + 1 >= end) return false;
+
+    const char *digits = bracket;
+    while (digits > text && isdigit((unsigned char)digits[-1])) digits--;
+    if (digits == bracket || digits == text || digits[-1] != ':') return false;
+
+    char *close;
+    *pid = atoi(digits);
+    *prio = (int)strtol(bracket + 2, &close, 10);
+    if (*close != ']') return false;
+    *after = close + 1;
+    return true;
+}
+
+/**
+ * Parse one sched_switch, sched_wakeup or sched_wakeup_new line
+ *
+ * Accepts ftrace's text output ("comm-pid [cpu] flags secs.usecs: event: key=value ...")
+ * and perf sched script output ("comm pid [cpu] secs.usecs: sched:event: ..."),
+ * whose fields are either key=value or compact ("comm:pid [prio] state ==> comm:pid [prio]").
+ * Returns false for anything else.
+ */
+bool parse_sched_event(const char *line, SchedEvent *event) {
+    static const char *const names[] = { "sched_switch: ", "sched_wakeup: ", "sched_wakeup_new: " };
+    const char *name = NULL;
+    size_t name_length = 0;
+    for (int n = 0; n < 3 && !name; n++) {
+        name = strstr(line, names[n]);
+        name_length = strlen(names[n]);
+        event->type = n == 0 ? SCHED_EVENT_SWITCH : SCHED_EVENT_WAKEUP;
+    }
+    if (!name) return false;
+
+    // The CPU is the first "[digits]"; the timestamp is the last "secs.frac:" token before the event
+    bool timed = false;
+    event->cpu = -1;
+    for (const char *c = line; c < name; c++) {
+        if (*c == '[' && event->cpu < 0 && isdigit((unsigned char)c[1])) {
+            char *close;
+            long cpu = strtol(c + 1, &close, 10);
+            if (*close == ']') event->cpu = (int)cpu;
+        } else if (*c == ':') {
+            const char *token = c;
+            while (token > line && token[-1] != ' ') token--;
+            if (parse_timestamp(token, c, &event->timestamp)) timed = true;
+        }
+    }
+    if (!timed) return false;
+
+    const char *body = name + name_length;
+    const char *after;
+    if (event->type == SCHED_EVENT_WAKEUP) {
+        event->prev_pid = 0;
+        if (find_field(body, "pid")) {
+            if (!field_int(body, "pid", &event->next_pid) || !field_int(body, "prio", &event->next_prio)) return false;
+        } else if (!parse_compact_task(body, body + strlen(body), &event->next_pid, &event->next_prio, &after)) {
+            return false;
+        }
+        return true;
+    }
+
+    if (find_field(body, "prev_pid")) {
+        const char *state = find_field(body, "prev_state");
+        if (!state || !field_int(body, "prev_pid", &event->prev_pid) ||
+            !field_int(body, "prev_prio", &event->prev_prio) || !field_int(body, "next_pid", &event->next_pid) ||
+            !field_int(body, "next_prio", &event->next_prio)) {
+            return false;
+        }
+        event->prev_runnable = state[0] == 'R';
+        return true;
+    }
+
+    const char *arrow = strstr(body, " ==> ");
+    if (!arrow || !parse_compact_task(body, arrow, &event->prev_pid, &event->prev_prio, &after)) return false;
+    while (*after == ' ') after++;
+    event->prev_runnable = *after == 'R';
+    const char *next = arrow + strlen(" ==> ");
+    return parse_compact_task(next, next + strlen(next), &event->next_pid, &event->next_prio, &after);
+}
+
+/**
+ * Find the table slot of 'pid', adding a task that is not runnable if it is new
+ *
+ * The table doubles at half load, which moves slots: pointers returned
+ * earlier are invalidated.
+ */
+ImportTask *find_import_task(ImportTable *table, int pid) {
+    if (2 * (table->count + 1) > table->capacity) {
+        ImportTask *old = table->slots;
+        int old_capacity = table->capacity;
+        table->capacity *= 2;
+        table->slots = (ImportTask *)calloc(table->capacity, sizeof(ImportTask));
+        if (!table->slots) {
+            perror("Failed to grow import task table");
+            exit(EXIT_FAILURE);
+        }
+        table->count = 0;
+        for (int i = 0; i < old_capacity; i++) {
+            if (old[i].pid != 0) *find_import_task(table, old[i].pid) = old[i];
+        }
+        free(old);
+    }
+
+    unsigned int mask = (unsigned int)table->capacity - 1;
+    unsigned int slot = ((unsigned int)pid * 2654435761u) & mask;
+    while (table->slots[slot].pid != 0 && table->slots[slot].pid != pid) slot = (slot + 1) & mask;
+    ImportTask *task = &table->slots[slot];
+    if (task->pid == 0) {
+        task->pid = pid;
+        task->priority = 0;
+        task->arrival = -1;
+        task->running_since = -1;
+        task->run = 0;
+        table->count++;
+    }
+    return task;
+}
+
+static sim_time_t ns_to_time(int64_t ns, int64_t tick_ns) {
+    return (ns / tick_ns) * TIME_SCALE + (ns % tick_ns) * TIME_SCALE / tick_ns;
+}
+
+static int trace_priority(int kernel_prio) {
+    int priority = KERNEL_MAX_PRIO - 1 - kernel_prio;
+    return priority < 0 ? 0 : priority;
+}
+
+/**
+ * Write a task's finished burst as one trace line; returns false if it rounds to no CPU time
+ */
+static bool emit_import_burst(FILE *out, const ImportTask *task, int64_t origin, int64_t tick_ns, int pid) {
+    sim_time_t burst = ns_to_time(task->run, tick_ns);
+    if (burst <= 0) return false;
+    fprintf(out, "%d %s %s %d\n", pid, time_str(ns_to_time(task->arrival - origin, tick_ns)), time_str(burst),
+            task->priority);
+    return true;
+}
+
+/**
+ * Convert a perf sched / ftrace scheduler dump into a trace file
+ *
+ * Every burst of a task, from sched_wakeup (or its first switch-in) until it
+ * switches out blocked, becomes one process: it arrives when the burst starts
+ * and its burst time is the CPU time it got in between, so preemptions (switch
+ * out in state R) do not end it. Arrivals are relative to the first event.
+ * The dump is streamed line by line and each burst is written as soon as it
+ * ends, so memory grows only with the number of distinct tasks, not with the
+ * dump. Bursts still open at the end of the dump end at its last event.
+ */
+void import_sched_dump(const char *dump_file, const char *output_file, int64_t tick_ns) {
+    FILE *in = fopen(dump_file, "r");
+    if (!in) {
+        perror(dump_file);
+        exit(EXIT_FAILURE);
+    }
+    setvbuf(in, NULL, _IOFBF, IMPORT_STREAM_BUFFER);
+    FILE *out = output_file ? fopen(output_file, "w") : stdout;
+    if (!out) {
+        perror(output_file);
+        exit(EXIT_FAILURE);
+    }
+
+    ImportTable table = { NULL, IMPORT_INITIAL_TASKS, 0 };
+    table.slots = (ImportTask *)calloc(table.capacity, sizeof(ImportTask));
+    if (!table.slots) {
+        perror("Failed to allocate import task table");
+        exit(EXIT_FAILURE);
+    }
+
+    fprintf(out, "# Imported from %s (1 tick = %" PRId64 " ns): PID arrival burst priority\n", dump_file, tick_ns);
+    char line[IMPORT_LINE_LENGTH];
+    int64_t origin = -1, last = 0;
+    long long events = 0;
+    int bursts = 0, max_cpu = -1;
+    while (fgets(line, sizeof(line), in)) {
+        size_t length = strlen(line);
+        if (length == sizeof(line) - 1 && line[length - 1] != '\n') {
+            int ch; // No scheduler event is this long; skip the rest of the line
+            while ((ch = fgetc(in)) != EOF && ch != '\n') {}
+            continue;
+        }
+        SchedEvent event;
+        if (!parse_sched_event(line, &event)) continue;
+
+        events++;
+        if (origin < 0) origin = event.timestamp;
+        int64_t now = event.timestamp > origin ? event.timestamp : origin;
+        if (now > last) last = now;
+        if (event.cpu > max_cpu) max_cpu = event.cpu;
+
+        // PID 0 is the idle task
+        if (event.type == SCHED_EVENT_SWITCH && event.prev_pid != 0) {
+            ImportTask *prev = find_import_task(&table, event.prev_pid);
+            prev->priority = trace_priority(event.prev_prio);
+            if (prev->running_since >= 0) {
+                prev->run += now - prev->running_since;
+                prev->running_since = -1;
+            }
+            if (!event.prev_runnable && prev->arrival >= 0) {
+                if (emit_import_burst(out, prev, origin, tick_ns, bursts + 1)) bursts++;
+                prev->arrival = -1;
+                prev->run = 0;
+            }
+        }
+        if (event.next_pid != 0) {
+            ImportTask *next = find_import_task(&table, event.next_pid);
+            next->priority = trace_priority(event.next_prio);
+            if (next->arrival < 0) { // Woken, or runnable since before the dump started
+                next->arrival = now;
+                next->run = 0;
+            }
+            if (event.type == SCHED_EVENT_SWITCH) next->running_since = now;
+        }
+    }
+    fclose(in);
+
+    for (int i = 0; i < table.capacity; i++) {
+        ImportTask *task = &table.slots[i];
+        if (task->pid == 0 || task->arrival < 0) continue;
+        if (task->running_since >= 0) task->run += last - task->running_since;
+        if (emit_import_burst(out, task, origin, tick_ns, bursts + 1)) bursts++;
+    }
+
+    if (out != stdout && fclose(out) != 0) {
+        perror(output_file);
+        exit(EXIT_FAILURE);
+    }
+    FILE *notes = output_file ? stdout : stderr;
+    if (events == 0) fprintf(notes, "Warning: No sched_switch or sched_wakeup events found in %s\n", dump_file);
+    fprintf(notes, "Imported %d burst(s) of %d task(s) from %lld scheduler event(s) on %d CPU(s)\n", bursts,
+            table.count, events, max_cpu + 1);
+    free(table.slots);
+}
+
+/************************* SIMULATION COMPONENTS *************************/
+
+static int compare_arrival_keys(const void *a, const void *b) {
+    const ArrivalKey *ka = (const ArrivalKey *)a;
+    const ArrivalKey *kb = (const ArrivalKey *)b;
+    if (ka->arrival_time != kb->arrival_time) return (ka->arrival_time < kb->arrival_time) ? -1 : 1;
+    return ka->process_idx - kb->process_idx;
+}
+
+/**
+ * Fill 'order' with process indices ordered by arrival time
+ *
+ * Simultaneous arrivals keep their trace order, matching a scan over all processes.
+ * 'keys' is caller-provided scratch space for process_count entries.
+ */
+void order_processes_by_arrival(const Process *processes, int process_count, ArrivalKey *keys, int *order) {
+    for (int i = 0; i < process_count; i++) {
+        keys[i].arrival_time = processes[i].arrival_time;
+        keys[i].process_idx = i;
+    }
+    heap_sort(keys, process_count, sizeof(ArrivalKey), compare_arrival_keys);
+    for (int i = 0; i < process_count; i++) order[i] = keys[i].process_idx;
+}
+
+/**
+ * Handle process arrivals at the current time
+ */
+void handle_arrivals(Process *processes, const int *arrival_order, int process_count, int *next_arrival,
+                    sim_time_t current_time, Algorithm algorithm, int *arrived_indices, int *arrival_count) {
+    // DONE: Implement process arrival handling
+    // 
+    // This function should:
+    // 1. Set *arrival_count to 0
+    // 2. Check all processes to find any that arrived at 'current_time'
+    // 3. For RR and SRTF algorithms, mark these processes as READY
+    // 4. For all algorithms, add the indices of newly arrived processes to arrived_indices[]
+    // 5. Increment *arrival_count for each arrived process
+    //
+    // Hint: processes[i].arrival_time == current_time indicates a process has just arrived
+    //
+    // Processes are visited in arrival order from *next_arrival, so each one is
+    // seen once and an arrival between two steps is picked up at the later step.
+	
+    *arrival_count = 0; // Initialize arrival count
+
+	while (*next_arrival < process_count
+		&& processes[arrival_order[*next_arrival]].arrival_time <= current_time) {
+		int i = arrival_order[(*next_arrival)++];
+		PROFILE_SCANS(ARRIVALS, 1);
+
+		if (algorithm == RR || algorithm == SRTF || algorithm == GANG || algorithm == EDF || algorithm == RM) {
+			processes[i].state = READY;
+		}							
+		arrived_indices[*arrival_count] = i;
+		(*arrival_count)++;
+	}
+}
+
+/**
+ * Handle quantum expiration for Round Robin scheduling
+ */
+void handle_rr_quantum_expiry(Process *processes, CPU *cpus, int cpu_count, sim_time_t time_quantum, 
+                           ReadyQueue *ready_queue, sim_time_t current_time) {
+    // DONE: Implement the Round Robin quantum expiration logic
+    //
+    // This function should:
+    // 1. Check all CPUs for processes that have used up their time quantum
+    // 2. For processes that have used up their quantum:
+    //    - Change their state to READY
+    //    - Remove them from their CPU (set CPU's current_process to NULL)
+    //    - Add them to the ready_queue
+    // 3. A process has used up its quantum when its quantum_used >= time_quantum
+    //
+    // Note: The current_time parameter is not used but kept for API consistency
+    (void)current_time; // Explicitly mark as unused
+
+	PROFILE_SCANS(QUANTUM_EXPIRY, cpu_count);
+	for (int i = 0; i < cpu_count; i++) {
+		Process *process = cpus[i].current_process;
+
+		if (process != NULL && process->quantum_used >= time_quantum) {
+			process->state = READY;
+			cpus[i].current_process = NULL;	
+            enqueue(ready_queue, (int)(process - processes));
+		}
+	}
+}
+
+
+/**
+ * Largest value in a padded remaining-time array
+ *
+ * Fixed-width blocks of independent lanes, so the compiler can keep each
+ * block in vector registers.
+ */
+static sim_time_t max_cpu_remaining(const sim_time_t *remaining, int lanes) {
+    sim_time_t block_max[SRTF_LANES];
+    for (int l = 0; l < SRTF_LANES; l++) block_max[l] = remaining[l];
+    for (int k = SRTF_LANES; k < lanes; k += SRTF_LANES) {
+        for (int l = 0; l < SRTF_LANES; l++) {
+            block_max[l] = remaining[k + l] > block_max[l] ? remaining[k + l] : block_max[l];
+        }
+    }
+    sim_time_t max = block_max[0];
+    for (int l = 1; l < SRTF_LANES; l++) max = block_max[l] > max ? block_max[l] : max;
+    return max;
+}
+
+/**
+ * First position in a padded remaining-time array holding more than 'remaining', or -1
+ *
+ * Each block is compared as a whole before the matching lane is located.
+ */
+static int first_preemptible_cpu(const sim_time_t *cpu_remaining, int lanes, sim_time_t remaining) {
+    for (int k = 0; k < lanes; k += SRTF_LANES) {
+        int hit = 0;
+        for (int l = 0; l < SRTF_LANES; l++) hit |= cpu_remaining[k + l] > remaining;
+        if (!hit) continue;
+        for (int l = 0; l < SRTF_LANES; l++) {
+            if (cpu_remaining[k + l] > remaining) return k + l;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Implement preemptive scheduling for SRTF
+ *
+ * 'cpu_remaining' (cpu_count rounded up to SRTF_LANES) and 'candidates'
+ * (cpu_count) are caller-provided scratch space.
+ */
+void handle_srtf_preemption(Process *processes, int process_count, CPU *cpus, int cpu_count,
+                            const int *cpu_order, sim_time_t *cpu_remaining, int *candidates,
+                            sim_time_t current_time) {
+    // DONE: Implement Shortest Remaining Time First preemptive logic
+    //
+    // This function should:
+    // 1. Find the process with the shortest remaining time that's ready to run
+    //    (not completed, not running, and has arrived by current_time)
+    // 2. If multiple processes tie for shortest time, prioritize by priority value
+    // 3. For each CPU, check if its running process should be preempted:
+    //    - If the shortest ready process has less remaining time than 
+    //      a currently running process, preempt the running process
+    //    - When preempting, consider preempting the running process with lowest priority
+    // 4. When a preemption occurs:
+    //    - Change preempted process state to WAITING
+    //    - Change new process state to RUNNING
+    //    - Update CPU's current_process pointer
+    //    - Set start_time and response_time for the new process if this is its first run
+    //
+    // Hint: You may need to repeat this until no more preemptions occur
+    //
+    // Repeating "place the shortest ready process on the first CPU (fastest
+    // first) that is idle or running something longer" places each CPU at most
+    // once, and the placed processes come out in shortest-first order. So one
+    // pass collects the best cpu_count ready processes, and they are placed in
+    // order against a dense array of the CPUs' remaining times.
+
+	int lanes = (cpu_count + SRTF_LANES - 1) / SRTF_LANES * SRTF_LANES;
+	PROFILE_SCANS(SRTF_PREEMPTION, lanes);
+	for (int k = 0; k < lanes; k++) {
+		Process *running = k < cpu_count ? cpus[cpu_order[k]].current_process : NULL;
+		if (k >= cpu_count) cpu_remaining[k] = TIME_UNSET;  // Padding is never preempted
+		else cpu_remaining[k] = running != NULL ? running->remaining_time : TIME_NEVER;  // Idle CPUs take anyone
+	}
+	sim_time_t longest = max_cpu_remaining(cpu_remaining, lanes);
+
+	// Best ready processes that could displace something, shortest first (trace order on ties)
+	int candidate_count = 0;
+	PROFILE_SCANS(SRTF_PREEMPTION, process_count);
+	for (int i = 0; i < process_count; i++) {
+		Process *process = &processes[i];
+		if (process->state != READY || process->arrival_time > current_time
+			|| process->remaining_time >= longest) {
+			continue;
+		}
+
+		int slot = candidate_count;
+		while (slot > 0) {
+			Process *ahead = &processes[candidates[slot - 1]];
+			PROFILE_COMPARES(SRTF_PREEMPTION, 1);
+			if (ahead->remaining_time < process->remaining_time
+				|| (ahead->remaining_time == process->remaining_time && ahead->priority >= process->priority)) {
+				break;
+			}
+			slot--;
+		}
+		if (slot == cpu_count) continue;
+		if (candidate_count < cpu_count) candidate_count++;
+		memmove(&candidates[slot + 1], &candidates[slot], (candidate_count - 1 - slot) * sizeof(int));
+		candidates[slot] = i;
+	}
+
+	// Place them; once one fits nowhere, no longer one can
+	for (int j = 0; j < candidate_count; j++) {
+		Process *min_process = &processes[candidates[j]];
+		int k = first_preemptible_cpu(cpu_remaining, lanes, min_process->remaining_time);
+		PROFILE_COMPARES(SRTF_PREEMPTION, lanes);
+		if (k < 0) break;
+
+		CPU *preempt_cpu = &cpus[cpu_order[k]];
+		if (preempt_cpu->current_process != NULL) {
+			preempt_cpu->current_process->state = WAITING;
+		}
+		min_process->state = RUNNING;
+		preempt_cpu->current_process = min_process;
+		cpu_remaining[k] = min_process->remaining_time;
+
+		if (min_process->start_time == TIME_UNSET) {
+			min_process->start_time = current_time;
+			min_process->response_time = current_time - min_process->arrival_time;
+		}
+	}
+}
+
+#ifdef SCHEDULER_SRTF_REFERENCE
+/**
+ * SRTF preemption as it was before the batched pass: one full process scan
+ * and CPU scan per preemption, repeated until nothing moves
+ *
+ * Test builds (fuzz_test) run it in the tick engine, so the batched pass in
+ * the event engine is always checked against it.
+ */
+static void handle_srtf_preemption_reference(Process *processes, int process_count, CPU *cpus, int cpu_count,
+                                             const int *cpu_order, sim_time_t current_time) {
+	CPU *preempt_cpu = NULL;
+
+	do {
+		// Decide which process is ready to run next
+		Process *min_process = NULL;
+		PROFILE_SCANS(SRTF_PREEMPTION, process_count);
+		for (int i = 0; i < process_count; i++) {
+			Process *process = &processes[i];
+
+			if (min_process != NULL && process->state == READY) PROFILE_COMPARES(SRTF_PREEMPTION, 1);
+			if (process->arrival_time <= current_time 
+				&& process->state == READY 
+				&& (min_process == NULL 
+					|| process->remaining_time < min_process->remaining_time
+					|| (process->remaining_time == min_process->remaining_time 
+						&& process->priority > min_process->priority))) {
+				min_process = process;
+			} 		
+		}
+
+		if (min_process == NULL) {
+			break;  // We can't preempt if there's no processes to run
+		}
+
+		// Decide which CPU is ready to kick out its process
+		preempt_cpu = NULL;
+
+		for (int i = 0; i < cpu_count; i++) {
+			CPU *cpu = &cpus[cpu_order[i]];  // fastest CPUs first
+			Process *curr_process = cpu->current_process;  
+			PROFILE_SCANS(SRTF_PREEMPTION, 1);
+			if (curr_process != NULL) PROFILE_COMPARES(SRTF_PREEMPTION, 1);
+			
+			if (curr_process == NULL 
+				|| (min_process->remaining_time < curr_process->remaining_time 
+				&& (preempt_cpu == NULL 
+					|| preempt_cpu->current_process->priority < curr_process->priority))) {
+
+				preempt_cpu = cpu;
+
+				// Perform preemption
+				if (curr_process != NULL) {
+					preempt_cpu->current_process->state = WAITING;	
+				}
+				min_process->state = RUNNING;
+				preempt_cpu->current_process = min_process;
+
+				if (min_process->start_time == TIME_UNSET) {
+					min_process->start_time = current_time;
+					min_process->response_time = current_time - min_process->arrival_time;
+				}
+				break;
+			}
+		}
+	} while (preempt_cpu != NULL);
+}
+#endif
+
+Process *tie_breaker(Process *p1, Process *p2) {
+	if (p1->priority > p2->priority) {
+		return p1;
+	} else if (p2->priority > p1->priority) {
+		return p2;
+	} else if (p1->arrival_time < p2->arrival_time) {
+		return p1;
+	} else if (p2->arrival_time < p1->arrival_time) {
+		return p2;
+	} else {
+		return p1;
+	}
+}
+
+/**
+ * Assign processes to idle CPUs based on the current scheduling algorithm
+ */
+void assign_processes_to_idle_cpus(Process *processes, int process_count, CPU *cpus, int cpu_count, 
+                                const int *cpu_order, Algorithm algorithm, ReadyQueue *ready_queue,
+                                sim_time_t current_time) {
+    // TODO: Implement process assignment to idle CPUs for all scheduling algorithms
+    //
+    // This function should:
+    // 1. For each idle CPU (where current_process is NULL):
+    //    a. Find the next process to run based on the scheduling algorithm:
+    //       - FCFS: Select process with earliest arrival time that is waiting
+    //       - RR: Take the next process from the ready_queue
+    //       - SJF: Select waiting process with shortest burst_time
+    //       - SRTF: Select waiting process with shortest remaining_time
+    //    b. If multiple processes tie in selection criteria, prioritize by:
+    //       - Higher priority value first
+    //       - Earlier arrival time second
+    // 2. For the selected process:
+    //    - Change state to RUNNING
+    //    - Assign it to the CPU
+    //    - Reset its quantum_used (for RR)
+    //    - Update start_time and response_time if this is first execution
+    //
+    // TODO Hint: Use a boolean array to track which processes are scheduled in this time step
+    //       to avoid scheduling the same process on multiple CPUs
+    //
+    // NOTE: a dispatched process leaves the WAITING state immediately, so the state
+    //       check below already excludes it and no per-step array is needed.
+
+	for (int c = 0; c < cpu_count; c++) {
+		int i = cpu_order[c];  // visit idle CPUs fastest first
+		Process *new_process = NULL;  // try and find the next process to run
+
+		if (cpus[i].current_process != NULL) {
+			continue;  // we only care about idle CPUS
+		}
+		
+		if (algorithm == RR) {
+			// Round robin just runs the next process in the queue
+			int idx = dequeue(ready_queue);
+
+			if (idx > -1) {
+				new_process = &processes[idx];	
+				new_process->quantum_used = 0;
+			} else {
+				break;
+			}
+		} 
+
+		// All other algorithms we need to check all processes
+		PROFILE_SCANS(ASSIGNMENT, process_count);
+		for (int i = 0; i < process_count; i++) {
+			if (processes[i].state != WAITING 
+				|| processes[i].arrival_time > current_time) {
+				// we only want to look at unscheduled,  waiting processes that have arrived
+			} else if (new_process == NULL) {
+				new_process = &processes[i];
+				continue;
 			} else {
+				PROFILE_COMPARES(ASSIGNMENT, 1);
 				switch (algorithm) {
 				case FCFS:
 					if (processes[i].arrival_time < new_process->arrival_time) {
@@ -610,430 +2506,2382 @@ void assign_processes_to_idle_cpus(Process *processes, int process_count, CPU *c
 					}
 					break;
 				case RR:  
+				case GANG:
+				case EDF:
+				case RM:
 					break;   // do nothing
 				}
 			}
 		}
 
-		if (new_process != NULL) {
-			new_process->state = RUNNING;
-			cpus[i].current_process = new_process;
-			if (new_process->response_time == -1) {
-				new_process->start_time = current_time;
-				new_process->response_time = current_time - new_process->arrival_time;
-			}
-		}
-	}
+		if (new_process != NULL) {
+			new_process->state = RUNNING;
+			cpus[i].current_process = new_process;
+			if (new_process->response_time == TIME_UNSET) {
+				new_process->start_time = current_time;
+				new_process->response_time = current_time - new_process->arrival_time;
+			}
+		}
+	}
+}
+
+/**
+ * Update waiting times for all waiting processes
+ */
+void update_waiting_times(Process *processes, int process_count, sim_time_t current_time, sim_time_t step) {
+    // DONE: Implement waiting time tracking
+    //
+    // This function should:
+    // 1. Iterate through all processes
+    // 2. For each process that:
+    //    - Has arrived (arrival_time <= current_time), AND
+    //    - Is not completed (state != COMPLETED), AND
+    //    - Is not currently running on a CPU (state != RUNNING)
+    //    Increment its waiting_time by the length of this step
+    //
+    // Hint: Waiting time is used to calculate performance metrics
+	
+	PROFILE_SCANS(WAITING, process_count);
+	for (int i = 0; i < process_count; i++) {
+		if (processes[i].arrival_time <= current_time 
+			&& processes[i].state != COMPLETED
+			&& processes[i].state != RUNNING) {
+			
+			processes[i].waiting_time += step;
+		}
+	}
+}
+
+/**
+ * Time a CPU of the given speed needs to finish 'remaining' work (rounded up)
+ */
+static sim_time_t time_to_finish(sim_time_t remaining, double speed) {
+    if (speed == DEFAULT_CPU_SPEED) return remaining;
+    return (sim_time_t)ceil((double)remaining / speed);
+}
+
+/**
+ * Work a CPU of the given speed completes in 'step' time (rounded down)
+ */
+static sim_time_t work_in(sim_time_t step, double speed) {
+    if (speed == DEFAULT_CPU_SPEED) return step;
+    return (sim_time_t)((double)step * speed);
+}
+
+/**
+ * Execute processes on CPUs for the current time step
+ */
+// TODO process is not being set to completed correctly and process is not getting 
+// kicked out when its done
+void execute_processes(Process *processes, int process_count, CPU *cpus, int cpu_count, 
+                     sim_time_t current_time, sim_time_t step, int *completed_count) {
+    // DONE: Implement CPU execution of processes for current time step
+    //
+    // This function should:
+    // 1. For each CPU:
+    //    a. If it has a process (current_process != NULL):
+    //       - Decrease the process's remaining_time by the work the CPU's
+    //         speed gets through in 'step'
+    //       - Increase the process's quantum_used by 'step' (for RR)
+    //       - Increase the CPU's busy_time by 'step'
+    //       - If remaining_time reaches 0:
+    //         * Mark process as COMPLETED
+    //         * Record the exact finish_time, which may fall part way
+    //           through the step on a fast CPU
+    //         * Set CPU's current_process to NULL
+    //         * Increment *completed_count
+    //    b. If it has no process:
+    //       - Increase the CPU's idle_time by 'step'
+    //
+    // Note: processes and process_count parameters are not used in this implementation
+    (void)processes;
+    (void)process_count;
+
+	PROFILE_SCANS(EXECUTE, cpu_count);
+	for (int i = 0; i < cpu_count; i++) {
+		Process *process = cpus[i].current_process;
+
+		if (process != NULL) {
+			sim_time_t needed = time_to_finish(process->remaining_time, cpus[i].speed);
+			sim_time_t work;
+			if (step >= needed) {
+				work = process->remaining_time;  // finishes within this step
+			} else {
+				work = work_in(step, cpus[i].speed);
+				if (work >= process->remaining_time) work = process->remaining_time - 1;
+			}
+			process->remaining_time -= work;
+			process->quantum_used += step;  // only used by RR
+			cpus[i].busy_time += step;
+			cpus[i].work_done += work;
+
+			if (process->remaining_time <= 0) {
+				process->state = COMPLETED;	
+				process->finish_time = current_time + needed;
+				cpus[i].current_process = NULL;
+				(*completed_count)++;
+			}
+		} else {
+			cpus[i].idle_time += step;
+		}
+	}
+}
+
+/**
+ * Find the time of the next scheduling event after current_time
+ *
+ * Events are the next arrival, a running process finishing, and an RR or gang
+ * time slice running out. Nothing the policies look at changes in between, so
+ * the event engine can jump straight there. Returns TIME_NEVER if nothing is
+ * pending.
+ */
+sim_time_t next_event_time(Process *processes, const int *arrival_order, int process_count, int next_arrival,
+                           CPU *cpus, int cpu_count, Algorithm algorithm, sim_time_t time_quantum,
+                           const GangTable *gangs, sim_time_t current_time) {
+    sim_time_t next = TIME_NEVER;
+
+    if (next_arrival < process_count) {
+        next = processes[arrival_order[next_arrival]].arrival_time;
+    }
+
+    PROFILE_SCANS(NEXT_EVENT, cpu_count);
+    for (int c = 0; c < cpu_count; c++) {
+        Process *process = cpus[c].current_process;
+        if (process == NULL) continue;
+
+        sim_time_t finish = current_time + time_to_finish(process->remaining_time, cpus[c].speed);
+        if (finish < next) next = finish;
+
+        if (algorithm == RR) {
+            sim_time_t expiry = current_time + (time_quantum - process->quantum_used);
+            if (expiry < next) next = expiry;
+        }
+    }
+
+    if (algorithm == GANG) {
+        PROFILE_SCANS(NEXT_EVENT, gangs->gang_count);
+        for (int g = 0; g < gangs->gang_count; g++) {
+            if (!gangs->gangs[g].running) continue;
+            sim_time_t expiry = current_time + (time_quantum - gangs->gangs[g].quantum_used);
+            if (expiry < next) next = expiry;
+        }
+    }
+
+    return next;
+}
+
+/************************* GANG SCHEDULING *************************/
+
+static int compare_group_keys(const void *a, const void *b) {
+    const GroupKey *ka = (const GroupKey *)a;
+    const GroupKey *kb = (const GroupKey *)b;
+    if (ka->group_id != kb->group_id) return (ka->group_id < kb->group_id) ? -1 : 1;
+    return ka->process_idx - kb->process_idx;
+}
+
+/**
+ * Allocate a gang table for up to 'process_capacity' processes
+ */
+void init_gangs(GangTable *table, int process_capacity) {
+    int n = process_capacity > 0 ? process_capacity : 1;
+    table->gangs = (Gang *)malloc(n * sizeof(Gang));
+    table->members = (int *)malloc(n * sizeof(int));
+    table->gang_of = (int *)malloc(n * sizeof(int));
+    table->keys = (GroupKey *)malloc(n * sizeof(GroupKey));
+    if (!table->gangs || !table->members || !table->gang_of || !table->keys) {
+        perror("Failed to allocate gang table");
+        exit(EXIT_FAILURE);
+    }
+    init_queue(&table->queue, n);
+    table->gang_count = 0;
+    table->fragmentation = 0;
+    table->idle_waste = 0;
+}
+
+/**
+ * Build the gang table from the processes' group ids
+ *
+ * Processes without a group (group_id < 0) become gangs of one. A gang with
+ * more members than CPUs could never be co-scheduled, so the trace is rejected
+ * (returns false).
+ */
+bool build_gangs(GangTable *table, Process *processes, int process_count, int cpu_count) {
+    GroupKey *keys = table->keys;
+    for (int i = 0; i < process_count; i++) {
+        keys[i].group_id = processes[i].group_id;
+        keys[i].process_idx = i;
+    }
+    heap_sort(keys, process_count, sizeof(GroupKey), compare_group_keys);
+
+    // Lay members out gang by gang, numbering gangs by first appearance in the trace
+    for (int i = 0; i < process_count; i++) table->gang_of[i] = -1;
+    table->gang_count = 0;
+    int offset = 0;
+    for (int idx = 0; idx < process_count; idx++) {
+        if (table->gang_of[idx] != -1) continue;
+
+        Gang *gang = &table->gangs[table->gang_count];
+        gang->group_id = processes[idx].group_id;
+        gang->first_member = offset;
+        gang->member_count = 0;
+        gang->arrived_count = 0;
+        gang->quantum_used = 0;
+        gang->running = false;
+
+        if (processes[idx].group_id < 0) {
+            table->members[offset++] = idx;
+            table->gang_of[idx] = table->gang_count;
+            gang->member_count = 1;
+        } else {
+            // Find this group's run of keys (binary search on the sorted keys)
+            int lo = 0, hi = process_count;
+            while (lo < hi) {
+                int mid = lo + (hi - lo) / 2;
+                if (keys[mid].group_id < gang->group_id) lo = mid + 1;
+                else hi = mid;
+            }
+            for (int k = lo; k < process_count && keys[k].group_id == gang->group_id; k++) {
+                table->members[offset++] = keys[k].process_idx;
+                table->gang_of[keys[k].process_idx] = table->gang_count;
+                gang->member_count++;
+            }
+        }
+
+        if (gang->member_count > cpu_count) {
+            fprintf(stderr, "Error: Group %d has %d members but only %d CPU(s); it can never be co-scheduled\n",
+                    gang->group_id, gang->member_count, cpu_count);
+            return false;
+        }
+        table->gang_count++;
+    }
+
+    reset_queue(&table->queue);
+    table->fragmentation = 0;
+    table->idle_waste = 0;
+    return true;
+}
+
+/**
+ * Release the gang table
+ */
+void cleanup_gangs(GangTable *table) {
+    free(table->gangs);
+    free(table->members);
+    free(table->gang_of);
+    free(table->keys);
+    cleanup_queue(&table->queue);
+}
+
+/**
+ * Queue a gang once all of its members have arrived
+ */
+void handle_gang_arrivals(GangTable *table, const int *arrived_indices, int arrival_count) {
+    for (int i = 0; i < arrival_count; i++) {
+        int g = table->gang_of[arrived_indices[i]];
+        Gang *gang = &table->gangs[g];
+        gang->arrived_count++;
+        if (gang->arrived_count == gang->member_count) {
+            enqueue(&table->queue, g);
+        }
+    }
+}
+
+/**
+ * Take a running gang off its CPUs and put it back in the queue
+ */
+static void deschedule_gang(GangTable *table, int g, CPU *cpus, int cpu_count) {
+    for (int c = 0; c < cpu_count; c++) {
+        if (cpus[c].gang != g) continue;
+        if (cpus[c].current_process != NULL) {
+            cpus[c].current_process->state = READY;
+            cpus[c].current_process = NULL;
+        }
+        cpus[c].gang = -1;
+    }
+    table->gangs[g].running = false;
+}
+
+/**
+ * Preempt every gang that has used up its time slice
+ *
+ * The whole gang leaves its CPUs at once, so members never run apart.
+ */
+void handle_gang_quantum_expiry(GangTable *table, Process *processes, CPU *cpus, int cpu_count,
+                                sim_time_t time_quantum) {
+    (void)processes;
+
+    PROFILE_SCANS(QUANTUM_EXPIRY, table->gang_count);
+    for (int g = 0; g < table->gang_count; g++) {
+        Gang *gang = &table->gangs[g];
+        if (gang->running && gang->quantum_used >= time_quantum) {
+            PROFILE_SCANS(QUANTUM_EXPIRY, cpu_count);
+            deschedule_gang(table, g, cpus, cpu_count);
+            enqueue(&table->queue, g);
+        }
+    }
+}
+
+/**
+ * Dispatch queued gangs in order while all their unfinished members fit
+ *
+ * Strict co-scheduling: the head gang either gets a CPU for every live member
+ * or nothing runs past it, even if a smaller gang behind it would fit.
+ */
+void assign_gangs_to_idle_cpus(GangTable *table, Process *processes, CPU *cpus, int cpu_count,
+                               const int *cpu_order, sim_time_t current_time) {
+    int free_cpus = 0;
+    PROFILE_SCANS(ASSIGNMENT, cpu_count);
+    for (int c = 0; c < cpu_count; c++) {
+        if (cpus[c].gang == -1) free_cpus++;
+    }
+
+    while (table->queue.size > 0) {
+        int g = peek(&table->queue);
+        Gang *gang = &table->gangs[g];
+
+        int live = 0;
+        PROFILE_SCANS(ASSIGNMENT, gang->member_count);
+        for (int m = 0; m < gang->member_count; m++) {
+            if (processes[table->members[gang->first_member + m]].state != COMPLETED) live++;
+        }
+        if (live > free_cpus) break;
+
+        dequeue(&table->queue);
+        free_cpus -= live;
+        gang->running = true;
+        gang->quantum_used = 0;
+
+        // Members take the fastest free CPUs
+        int next_cpu = 0;
+        PROFILE_SCANS(ASSIGNMENT, gang->member_count);
+        for (int m = 0; m < gang->member_count; m++) {
+            Process *member = &processes[table->members[gang->first_member + m]];
+            if (member->state == COMPLETED) continue;
+
+            while (cpus[cpu_order[next_cpu]].gang != -1) next_cpu++;
+            CPU *cpu = &cpus[cpu_order[next_cpu]];
+            cpu->gang = g;
+            cpu->current_process = member;
+            member->state = RUNNING;
+            if (member->response_time == TIME_UNSET) {
+                member->start_time = current_time;
+                member->response_time = current_time - member->arrival_time;
+            }
+        }
+    }
+}
+
+/**
+ * Count this step's co-scheduling waste
+ *
+ * Idle waste is a CPU held by a gang whose member there has already finished;
+ * fragmentation is a free CPU left idle because the next gang did not fit.
+ */
+void account_gang_waste(GangTable *table, CPU *cpus, int cpu_count, sim_time_t step) {
+    for (int c = 0; c < cpu_count; c++) {
+        if (cpus[c].current_process != NULL) continue;
+        if (cpus[c].gang != -1) {
+            table->idle_waste += step;
+        } else if (table->queue.size > 0) {
+            table->fragmentation += step;
+        }
+    }
+}
+
+/**
+ * Advance running gangs' time slices and free the CPUs of finished gangs
+ */
+void release_finished_gangs(GangTable *table, Process *processes, CPU *cpus, int cpu_count, sim_time_t step) {
+    PROFILE_SCANS(EXECUTE, table->gang_count);
+    for (int g = 0; g < table->gang_count; g++) {
+        Gang *gang = &table->gangs[g];
+        if (!gang->running) continue;
+
+        gang->quantum_used += step;
+        bool finished = true;
+        for (int m = 0; m < gang->member_count; m++) {
+            PROFILE_SCANS(EXECUTE, 1);
+            if (processes[table->members[gang->first_member + m]].state != COMPLETED) {
+                finished = false;
+                break;
+            }
+        }
+        if (finished) {
+            PROFILE_SCANS(EXECUTE, cpu_count);
+            deschedule_gang(table, g, cpus, cpu_count);
+        }
+    }
+}
+
+/************************* REAL-TIME SCHEDULING *************************/
+
+/**
+ * Scheduling key of a job: absolute deadline (EDF) or period (RM)
+ *
+ * Jobs without a deadline or period rank behind every real-time job.
+ */
+static sim_time_t realtime_key(const Process *p, Algorithm algorithm) {
+    if (algorithm == RM) return p->period > 0 ? p->period : TIME_NEVER;
+    return p->deadline != TIME_UNSET ? p->deadline : TIME_NEVER;
+}
+
+/**
+ * Whether job 'a' outranks job 'b' under EDF or RM
+ *
+ * Ties go to the higher priority, then the earlier arrival, then trace order,
+ * matching tie_breaker(). Counted as an assignment comparison: the heap and
+ * the dispatch victim search only run in that phase.
+ */
+static bool realtime_precedes(const Process *a, const Process *b, Algorithm algorithm) {
+    PROFILE_COMPARES(ASSIGNMENT, 1);
+    sim_time_t ka = realtime_key(a, algorithm), kb = realtime_key(b, algorithm);
+    if (ka != kb) return ka < kb;
+    if (a->priority != b->priority) return a->priority > b->priority;
+    if (a->arrival_time != b->arrival_time) return a->arrival_time < b->arrival_time;
+    return a < b;
+}
+
+/**
+ * Allocate a job heap for up to 'capacity' jobs
+ */
+void init_job_heap(JobHeap *heap, int capacity) {
+    heap->capacity = capacity > 0 ? capacity : 1;
+    heap->items = (int *)malloc(heap->capacity * sizeof(int));
+    if (!heap->items) {
+        perror("Failed to allocate job heap");
+        exit(EXIT_FAILURE);
+    }
+    heap->size = 0;
+}
+
+/**
+ * Release a job heap
+ */
+void cleanup_job_heap(JobHeap *heap) {
+    free(heap->items);
+    heap->items = NULL;
+}
+
+/**
+ * Add a ready job to the heap
+ */
+void push_job(JobHeap *heap, Process *processes, int process_idx, Algorithm algorithm) {
+    if (heap->size >= heap->capacity) {
+        fprintf(stderr, "Error: Job heap overflow!\n");
+        return;
+    }
+    int pos = heap->size++;
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!realtime_precedes(&processes[process_idx], &processes[heap->items[parent]], algorithm)) break;
+        heap->items[pos] = heap->items[parent];
+        pos = parent;
+    }
+    heap->items[pos] = process_idx;
+}
+
+/**
+ * Remove and return the highest-ranked job, or -1 if the heap is empty
+ */
+int pop_job(JobHeap *heap, Process *processes, Algorithm algorithm) {
+    if (heap->size == 0) return -1;
+    int top = heap->items[0];
+    int last = heap->items[--heap->size];
+
+    int pos = 0;
+    for (;;) {
+        int child = 2 * pos + 1;
+        if (child >= heap->size) break;
+        if (child + 1 < heap->size
+            && realtime_precedes(&processes[heap->items[child + 1]], &processes[heap->items[child]], algorithm)) {
+            child++;
+        }
+        if (!realtime_precedes(&processes[heap->items[child]], &processes[last], algorithm)) break;
+        heap->items[pos] = heap->items[child];
+        pos = child;
+    }
+    if (heap->size > 0) heap->items[pos] = last;
+    return top;
+}
+
+/**
+ * Put a job on a CPU, recording its first start
+ */
+static void start_job(CPU *cpu, Process *job, sim_time_t current_time) {
+    job->state = RUNNING;
+    cpu->current_process = job;
+    if (job->start_time == TIME_UNSET) {
+        job->start_time = current_time;
+        job->response_time = current_time - job->arrival_time;
+    }
+}
+
+/**
+ * Dispatch ready EDF/RM jobs: fill idle CPUs, then preempt outranked jobs
+ *
+ * Idle CPUs are filled fastest first. While the best waiting job outranks the
+ * lowest-ranked running job, the two swap. Each decision is O(log n) in ready
+ * jobs plus O(cpus), so large release counts stay cheap.
+ */
+void dispatch_realtime_jobs(Process *processes, CPU *cpus, int cpu_count, const int *cpu_order,
+                            Algorithm algorithm, JobHeap *heap, sim_time_t current_time) {
+    for (int c = 0; c < cpu_count && heap->size > 0; c++) {
+        PROFILE_SCANS(ASSIGNMENT, 1);
+        CPU *cpu = &cpus[cpu_order[c]];
+        if (cpu->current_process == NULL) {
+            start_job(cpu, &processes[pop_job(heap, processes, algorithm)], current_time);
+        }
+    }
+
+    while (heap->size > 0) {
+        CPU *victim = NULL;
+        PROFILE_SCANS(ASSIGNMENT, cpu_count);
+        for (int c = 0; c < cpu_count; c++) {
+            CPU *cpu = &cpus[cpu_order[c]];
+            if (cpu->current_process == NULL) continue;
+            if (victim == NULL || realtime_precedes(victim->current_process, cpu->current_process, algorithm)) {
+                victim = cpu;
+            }
+        }
+        if (victim == NULL || !realtime_precedes(&processes[heap->items[0]], victim->current_process, algorithm)) {
+            break;
+        }
+
+        Process *preempted = victim->current_process;
+        start_job(victim, &processes[pop_job(heap, processes, algorithm)], current_time);
+        preempted->state = READY;
+        push_job(heap, processes, (int)(preempted - processes), algorithm);
+    }
+}
+
+/**
+ * Compute deadline misses and the sufficient schedulability bounds
+ *
+ * Bounds use task density (burst / min(deadline, period)) on cpu_count
+ * identical CPUs: EDF uses the GFB bound m - (m-1) * max_density (exact,
+ * U <= 1, on one CPU with implicit deadlines); RM uses Liu & Layland's
+ * n(2^(1/n) - 1) on one CPU and m/2 * (1 - max_density) + max_density on more.
+ */
+void summarize_realtime(const Process *processes, int process_count, int cpu_count, RealTimeSummary *summary) {
+    memset(summary, 0, sizeof(*summary));
+
+    for (int i = 0; i < process_count; i++) {
+        const Process *p = &processes[i];
+        if (p->period > 0 && p->job == 0) {
+            sim_time_t window = p->deadline - p->arrival_time;
+            if (window > p->period) window = p->period;
+            double density = (double)p->burst_time / window;
+            summary->tasks++;
+            summary->utilization += (double)p->burst_time / p->period;
+            summary->density += density;
+            if (density > summary->max_density) summary->max_density = density;
+        }
+
+        if (p->deadline == TIME_UNSET) continue;
+        summary->jobs++;
+        if (p->finish_time == TIME_UNSET || p->finish_time > p->deadline) {
+            summary->misses++;
+            if (p->finish_time != TIME_UNSET && p->finish_time - p->deadline > summary->max_lateness) {
+                summary->max_lateness = p->finish_time - p->deadline;
+            }
+        }
+    }
+
+    double m = cpu_count;
+    summary->edf_bound = m - (m - 1.0) * summary->max_density;
+    if (cpu_count == 1) {
+        int n = summary->tasks > 0 ? summary->tasks : 1;
+        summary->rm_bound = n * (pow(2.0, 1.0 / n) - 1.0);
+    } else {
+        summary->rm_bound = m / 2.0 * (1.0 - summary->max_density) + summary->max_density;
+    }
+}
+
+/************************* MAIN SIMULATION *************************/
+
+/**
+ * Allocate a simulation context for up to 'process_capacity' processes on 'cpu_count' CPUs
+ *
+ * cpu_speeds may be NULL for identical CPUs.
+ */
+void init_sim_context(SimContext *ctx, int process_capacity, int cpu_count, const double *cpu_speeds) {
+    int n = process_capacity > 0 ? process_capacity : 1;
+    ctx->process_capacity = process_capacity;
+    ctx->cpu_count = cpu_count;
+    ctx->cpus = (CPU *)calloc(cpu_count, sizeof(CPU));
+    ctx->cpu_order = (int *)malloc(cpu_count * sizeof(int));
+    ctx->arrival_keys = (ArrivalKey *)malloc(n * sizeof(ArrivalKey));
+    ctx->arrival_order = (int *)malloc(n * sizeof(int));
+    ctx->arrived_indices = (int *)malloc(n * sizeof(int));
+    int lanes = (cpu_count + SRTF_LANES - 1) / SRTF_LANES * SRTF_LANES;
+    ctx->cpu_remaining = (sim_time_t *)malloc(lanes * sizeof(sim_time_t));
+    ctx->srtf_candidates = (int *)malloc(cpu_count * sizeof(int));
+    if (!ctx->cpus || !ctx->cpu_order || !ctx->arrival_keys || !ctx->arrival_order || !ctx->arrived_indices ||
+        !ctx->cpu_remaining || !ctx->srtf_candidates) {
+        perror("Failed to allocate simulation context");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < cpu_count; i++) {
+        ctx->cpus[i].id = i;
+        ctx->cpus[i].speed = cpu_speeds ? cpu_speeds[i] : DEFAULT_CPU_SPEED;
+    }
+    order_cpus_by_capacity(ctx->cpus, cpu_count, ctx->cpu_order);
+
+    init_queue(&ctx->ready_queue, n);
+    init_gangs(&ctx->gangs, n);
+    init_job_heap(&ctx->job_heap, n);
+    init_timeline(&ctx->timeline, INITIAL_TIMELINE_CAPACITY, cpu_count);
+    ctx->total_time = 0;
+}
+
+/**
+ * Release everything owned by a simulation context
+ */
+void cleanup_sim_context(SimContext *ctx) {
+    cleanup_timeline(&ctx->timeline);
+    cleanup_job_heap(&ctx->job_heap);
+    cleanup_gangs(&ctx->gangs);
+    cleanup_queue(&ctx->ready_queue);
+    free(ctx->srtf_candidates);
+    free(ctx->cpu_remaining);
+    free(ctx->arrived_indices);
+    free(ctx->arrival_order);
+    free(ctx->arrival_keys);
+    free(ctx->cpu_order);
+    free(ctx->cpus);
+}
+
+/**
+ * Simulate one trace using a preallocated context and return the total time
+ *
+ * Returns TIME_UNSET if the trace cannot be scheduled (a gang larger than the
+ * machine). Process run-time state, CPUs and the timeline are reset first, so
+ * the same trace can be run repeatedly. Nothing here allocates unless the timeline
+ * outgrows every previous run.
+ *
+ * Each step runs the scheduling phases at current_time and then advances by
+ * one tick (ENGINE_TICK) or straight to the next event (ENGINE_EVENT), so the
+ * event engine's cost depends on the number of events, not on time resolution.
+ */
+sim_time_t run_simulation(SimContext *ctx, Process *processes, int process_count, const SimConfig *config) {
+    if (process_count > ctx->process_capacity) {
+        fprintf(stderr, "Error: Context sized for %d processes cannot simulate %d\n",
+                ctx->process_capacity, process_count);
+        exit(EXIT_FAILURE);
+    }
+
+    Algorithm algorithm = config->algorithm;
+    sim_time_t time_quantum = config->time_quantum;
+    Engine engine = config->engine;
+    CPU *cpus = ctx->cpus;
+    int cpu_count = ctx->cpu_count;
+    const int *cpu_order = ctx->cpu_order;
+    int *arrival_order = ctx->arrival_order;
+    int *arrived_indices = ctx->arrived_indices;
+    GangTable *gangs = &ctx->gangs;
+    Timeline *timeline = &ctx->timeline;
+
+    // Reset state left over from any previous run
+    for (int i = 0; i < process_count; i++) reset_process(&processes[i]);
+    for (int i = 0; i < cpu_count; i++) {
+        cpus[i].current_process = NULL;
+        cpus[i].idle_time = 0;
+        cpus[i].busy_time = 0;
+        cpus[i].work_done = 0;
+        cpus[i].gang = -1;
+    }
+    reset_queue(&ctx->ready_queue);
+    ctx->job_heap.size = 0;
+    reset_timeline(timeline);
+    if (algorithm == GANG && !build_gangs(gangs, processes, process_count, cpu_count)) return TIME_UNSET;
+
+    order_processes_by_arrival(processes, process_count, ctx->arrival_keys, arrival_order);
+    PROFILE_RESET();
+    int next_arrival = 0;
+    sim_time_t current_time = 0;
+    int completed_count = 0;
+
+    // Main Simulation Loop
+    while (completed_count < process_count) {
+        // TODO: Implement the simulation main loop
+        // 
+        // This is the framework for the simulation loop. You need to:
+        // 1. Handle new process arrivals via handle_arrivals()
+        // 2. For Round Robin: enqueue newly arrived processes and handle quantum expiry
+        // 3. For SRTF: check for preemptions
+        // 4. Assign processes to idle CPUs based on the scheduling algorithm
+        // 5. Pick the step length (one tick, or up to the next event)
+        // 6. Update the timeline data structure
+        // 7. Update waiting times
+        // 8. Execute processes on CPUs
+        // 9. Advance time
+
+        PROFILE_STEP();
+
+        // Handle new process arrivals
+        int arrival_count = 0;
+        PROFILE_BEGIN(ARRIVALS);
+        handle_arrivals(processes, arrival_order, process_count, &next_arrival, current_time, algorithm,
+                        arrived_indices, &arrival_count);
+        PROFILE_END(ARRIVALS);
+
+        // Enqueue newly arrived processes for Round Robin
+        PROFILE_BEGIN(QUANTUM_EXPIRY);
+        if (algorithm == RR) {
+            for (int i = 0; i < arrival_count; i++) {
+                enqueue(&ctx->ready_queue, arrived_indices[i]);
+            }
+            handle_rr_quantum_expiry(processes, cpus, cpu_count, time_quantum, &ctx->ready_queue, current_time);
+        }
+
+        // Queue gangs whose members have all arrived and rotate expired time slices
+        if (algorithm == GANG) {
+            handle_gang_arrivals(gangs, arrived_indices, arrival_count);
+            handle_gang_quantum_expiry(gangs, processes, cpus, cpu_count, time_quantum);
+        }
+        PROFILE_END(QUANTUM_EXPIRY);
+
+        // Handle SRTF preemption
+        if (algorithm == SRTF) {
+            PROFILE_BEGIN(SRTF_PREEMPTION);
+#ifdef SCHEDULER_SRTF_REFERENCE
+            if (engine == ENGINE_TICK) {
+                handle_srtf_preemption_reference(processes, process_count, cpus, cpu_count, cpu_order,
+                                                 current_time);
+            } else
+#endif
+            handle_srtf_preemption(processes, process_count, cpus, cpu_count, cpu_order, ctx->cpu_remaining,
+                                   ctx->srtf_candidates, current_time);
+            PROFILE_END(SRTF_PREEMPTION);
+        }
+
+        // Queue released real-time jobs by deadline (EDF) or period (RM)
+        PROFILE_BEGIN(ASSIGNMENT);
+        if (algorithm == EDF || algorithm == RM) {
+            for (int i = 0; i < arrival_count; i++) {
+                push_job(&ctx->job_heap, processes, arrived_indices[i], algorithm);
+            }
+        }
+
+        // Assign processes to idle CPUs
+        if (algorithm == GANG) {
+            assign_gangs_to_idle_cpus(gangs, processes, cpus, cpu_count, cpu_order, current_time);
+        } else if (algorithm == EDF || algorithm == RM) {
+            dispatch_realtime_jobs(processes, cpus, cpu_count, cpu_order, algorithm, &ctx->job_heap, current_time);
+        } else {
+            assign_processes_to_idle_cpus(processes, process_count, cpus, cpu_count, cpu_order, algorithm, 
+                                       &ctx->ready_queue, current_time);
+        }
+        PROFILE_END(ASSIGNMENT);
+
+        // Pick the step length; with nothing left to happen the simulation is stuck
+        PROFILE_BEGIN(NEXT_EVENT);
+        sim_time_t next_time = next_event_time(processes, arrival_order, process_count, next_arrival,
+                                               cpus, cpu_count, algorithm, time_quantum, gangs, current_time);
+        PROFILE_END(NEXT_EVENT);
+        if (next_time == TIME_NEVER) {
+            fprintf(stderr, "Warning: Simulation stalled with %d process(es) unfinished. Aborting.\n",
+                    process_count - completed_count);
+            break;
+        }
+        sim_time_t step = (engine == ENGINE_TICK) ? TICKS(1) : next_time - current_time;
+
+        // Update timeline
+        PROFILE_BEGIN(TIMELINE);
+        PROFILE_SCANS(TIMELINE, cpu_count);
+        for (int c = 0; c < cpu_count; c++) {
+            int pid = (cpus[c].current_process != NULL) ? cpus[c].current_process->pid : -1;
+            record_timeline(timeline, c, pid, current_time, current_time + step);
+        }
+        if (algorithm == GANG) {
+            account_gang_waste(gangs, cpus, cpu_count, step);
+        }
+        PROFILE_END(TIMELINE);
+
+        // Update waiting times for processes (EDF/RM skip this O(n) scan: with up to
+        // millions of releases it would dominate, and reports derive waiting from turnaround)
+        if (algorithm != EDF && algorithm != RM) {
+            PROFILE_BEGIN(WAITING);
+            update_waiting_times(processes, process_count, current_time, step);
+            PROFILE_END(WAITING);
+        }
+
+        // Execute processes on CPUs
+        PROFILE_BEGIN(EXECUTE);
+        execute_processes(processes, process_count, cpus, cpu_count, current_time, step, &completed_count);
+        if (algorithm == GANG) {
+            release_finished_gangs(gangs, processes, cpus, cpu_count, step);
+        }
+        PROFILE_END(EXECUTE);
+
+        // Advance time
+        current_time += step;
+    }
+    finish_timeline(timeline);
+
+    ctx->total_time = current_time; // Record total simulation time
+    return current_time;
+}
+
+/**
+ * Run the entire CPU scheduling simulation and print the results
+ *
+ * FORMAT_TEXT prints the banner and the full human-readable report; the other
+ * formats skip both and emit only machine-readable results.
+ */
+void simulate(Process *processes, int process_count, int cpu_count, const SimConfig *config,
+              const double *cpu_speeds, OutputFormat format, const TimelineView *view) {
+    SimContext ctx;
+    init_sim_context(&ctx, process_count, cpu_count, cpu_speeds);
+    if (view->spill_dir) spill_timeline(&ctx.timeline, view->spill_dir);
+    Algorithm algorithm = config->algorithm;
+
+    if (format != FORMAT_TEXT) {
+        sim_time_t total_time = run_simulation(&ctx, processes, process_count, config);
+        if (total_time == TIME_UNSET) exit(EXIT_FAILURE);
+        if (view->export_path) export_timeline(&ctx.timeline, view->from, view->to, view->export_path);
+        emit_results(format, processes, process_count, ctx.cpus, cpu_count, config, total_time,
+                     algorithm == GANG ? &ctx.gangs : NULL);
+#ifdef SCHEDULER_PROFILE
+        print_profile(stderr); // Keep machine-readable stdout clean
+#endif
+        cleanup_sim_context(&ctx);
+        return;
+    }
+
+    // Display simulation header
+    printf("\nStarting simulation with %s on %d CPU(s)%s\n", 
+           algorithm_name(algorithm),
+           cpu_count, 
+           (algorithm == RR || algorithm == GANG) ? ", Quantum=" : "");
+    if (algorithm == RR || algorithm == GANG) printf("%s", time_str(config->time_quantum));
+    printf("\n");
+    if (has_heterogeneous_cpus(ctx.cpus, cpu_count)) {
+        printf("CPU speeds:");
+        for (int c = 0; c < cpu_count; c++) printf(" %.2f", ctx.cpus[c].speed);
+        printf("\n");
+    }
+
+    sim_time_t total_time = run_simulation(&ctx, processes, process_count, config);
+    if (total_time == TIME_UNSET) exit(EXIT_FAILURE);
+    if (view->export_path) export_timeline(&ctx.timeline, view->from, view->to, view->export_path);
+    print_results(processes, process_count, ctx.cpus, cpu_count, &ctx.timeline, total_time,
+                  algorithm == GANG ? &ctx.gangs : NULL, view);
+#ifdef SCHEDULER_PROFILE
+    print_profile(stdout);
+#endif
+
+    cleanup_sim_context(&ctx);
+}
+
+/************************* RESULTS DISPLAY *************************/
+
+/**
+ * Print the execution timeline visualization of [from, to)
+ *
+ * One column per tick, showing the process each CPU was running at the start
+ * of that tick. Each line re-seeks the timeline, so any window of a spilled
+ * timeline is printed without reading the rest.
+ */
+void print_timeline(const Timeline *timeline, sim_time_t from, sim_time_t to, Process *processes,
+                    int process_count, int cpu_count) {
+    printf("\nExecution Timeline:\n");
+    int time_units_per_line = (TIMELINE_WIDTH - 5) / TIME_UNIT_WIDTH;
+    if (time_units_per_line <= 0) time_units_per_line = 1; // Ensure at least 1 unit per line
+    sim_time_t first_tick = from / TIME_SCALE;
+    sim_time_t last_tick = (to + TIME_SCALE - 1) / TIME_SCALE;
+
+    int *grid = (int *)malloc((size_t)cpu_count * time_units_per_line * sizeof(int)); // PID per CPU and tick
+    if (!grid) {
+        perror("Failed to allocate timeline grid");
+        exit(EXIT_FAILURE);
+    }
+
+    // Print color key
+    printf("\nColor Key:\n");
+    for (int i = 0; i < process_count; i++) {
+        printf("%sPID %-2d%s ", get_color_for_pid(processes[i].pid), processes[i].pid, COLOR_RESET);
+        if ((i + 1) % 8 == 0 && i + 1 < process_count) printf("\n");
+    }
+    printf("\n");
+
+    // Print timeline in segments
+    for (sim_time_t start_t = first_tick; start_t < last_tick; start_t += time_units_per_line) {
+        sim_time_t end_t = start_t + time_units_per_line;
+        if (end_t > last_tick) end_t = last_tick;
+
+        // Paint the segments overlapping this line onto the grid (-1 = idle)
+        for (int i = 0; i < cpu_count * time_units_per_line; i++) grid[i] = -1;
+        TimelineReader reader;
+        seek_timeline(&reader, timeline, TICKS(start_t), TICKS(end_t));
+        for (const TimelineSegment *segment; (segment = next_timeline_segment(&reader)) != NULL; ) {
+            sim_time_t lo = (segment->start + TIME_SCALE - 1) / TIME_SCALE;
+            sim_time_t hi = (segment->end + TIME_SCALE - 1) / TIME_SCALE;
+            if (lo < start_t) lo = start_t;
+            if (hi > end_t) hi = end_t;
+            for (sim_time_t t = lo; t < hi; t++) {
+                grid[segment->cpu * time_units_per_line + (t - start_t)] = segment->pid;
+            }
+        }
+        close_timeline_reader(&reader);
+
+        printf("\nTime %" PRId64 " to %" PRId64 ":\n", start_t, end_t - 1);
+
+        // Time markers
+        printf("Time: ");
+        for (sim_time_t t = start_t; t < end_t; t++) {
+            printf("%-5" PRId64, t); // Print time marker for each unit
+        }
+        printf("\n");
+
+        // CPU timelines
+        for (int c = 0; c < cpu_count; c++) {
+            printf("CPU%-2d ", c);
+            for (sim_time_t t = start_t; t < end_t; t++) {
+                int pid = grid[c * time_units_per_line + (t - start_t)];
+                if (pid == -1) {
+                    printf("%-*s", TIME_UNIT_WIDTH, "."); // Idle marker
+                } else {
+                    printf("%s%-*d%s", get_color_for_pid(pid), TIME_UNIT_WIDTH, pid, COLOR_RESET);
+                }
+            }
+            printf("\n");
+        }
+    }
+    free(grid);
+}
+
+/**
+ * Write the segments overlapping [from, to) to 'path' as CSV, clipped to the window
+ *
+ * Rows come in order of segment end time, as stored.
+ */
+void export_timeline(const Timeline *timeline, sim_time_t from, sim_time_t to, const char *path) {
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    fprintf(out, "CPU,PID,Start,End\n");
+    TimelineReader reader;
+    seek_timeline(&reader, timeline, from, to);
+    for (const TimelineSegment *segment; (segment = next_timeline_segment(&reader)) != NULL; ) {
+        sim_time_t start = segment->start > from ? segment->start : from;
+        sim_time_t end = segment->end < to ? segment->end : to;
+        fprintf(out, "%d,%d,%s,%s\n", segment->cpu, segment->pid, time_str(start), time_str(end));
+    }
+    close_timeline_reader(&reader);
+    if (fclose(out) != 0) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Print detailed process statistics
+ */
+void print_process_stats(Process *processes, int process_count) {
+    printf("\nProcess Statistics:\n");
+    printf("%-6s %-7s %-7s %-7s %-7s %-7s %-7s %-7s\n",
+           "PID", "Arrival", "Burst", "Start", "Finish", "Turn.", "Waiting", "Resp.");
+    printf("----------------------------------------------------------------\n");
+
+    for (int i = 0; i < process_count; i++) {
+        Process *p = &processes[i];
+        if (p->finish_time != TIME_UNSET) { // Only calculate for completed processes
+            sim_time_t turnaround = p->finish_time - p->arrival_time;
+            sim_time_t waiting = turnaround - p->burst_time;
+            if (waiting < 0) waiting = 0; // Cannot be negative
+
+            printf("%-6d %-7s %-7s %-7s %-7s %-7s %-7s %-7s\n",
+                   p->pid, time_str(p->arrival_time), time_str(p->burst_time),
+                   time_str(p->start_time), time_str(p->finish_time), time_str(turnaround),
+                   time_str(waiting), time_str(p->response_time));
+        } else {
+            printf("%-6d %-7s %-7s %-7s %-7s %-7s %-7s %-7s\n",
+                   p->pid, time_str(p->arrival_time), time_str(p->burst_time),
+                   (p->start_time == TIME_UNSET ? "N/A" : "-"), "N/A", "N/A", "N/A",
+                   (p->response_time == TIME_UNSET ? "N/A" : "-"));
+        }
+    }
+    printf("----------------------------------------------------------------\n");
+}
+
+/**
+ * Print CPU usage statistics
+ */
+void print_cpu_stats(CPU *cpus, int cpu_count) {
+    printf("\nCPU Statistics:\n");
+    printf("%-6s %-9s %-9s %-12s\n", "CPU ID", "Busy Time", "Idle Time", "Utilization");
+    printf("------------------------------------------\n");
+    for (int i = 0; i < cpu_count; i++) {
+        double utilization = 0.0;
+        sim_time_t cpu_total_time = cpus[i].busy_time + cpus[i].idle_time;
+        if (cpu_total_time > 0) {
+            utilization = 100.0 * cpus[i].busy_time / cpu_total_time;
+        }
+        printf("%-6d %-9s %-9s %-11.2f%%\n", cpus[i].id, time_str(cpus[i].busy_time), time_str(cpus[i].idle_time),
+               utilization);
+    }
+    printf("------------------------------------------\n");
+}
+
+/**
+ * Print average performance metrics, with queueing-model estimates beside them
+ */
+void print_average_stats(Process *processes, int process_count, CPU *cpus, int cpu_count) {
+    SimSummary summary;
+    summarize_results(processes, process_count, cpus, cpu_count, &summary);
+
+    if (summary.completed > 0) {
+        printf("\nAverage Statistics (for %d completed processes):\n", summary.completed);
+        printf("  Average Turnaround Time: %.2f\n", summary.avg_turnaround);
+        printf("  Average Waiting Time:    %.2f\n", summary.avg_waiting);
+        printf("  Average Response Time:   %.2f\n", summary.avg_response);
+
+        double total_speed = 0.0;
+        for (int i = 0; i < cpu_count; i++) total_speed += cpus[i].speed;
+        QueueingEstimate estimate;
+        fit_queueing_model(processes, process_count, cpu_count, total_speed / cpu_count, &estimate);
+        print_queueing_estimates(&estimate, &summary);
+    } else {
+        printf("\nNo processes completed. Cannot calculate average statistics.\n");
+    }
+}
+
+/**
+ * Print capacity-aware statistics for heterogeneous CPUs
+ *
+ * Finish times are exact: a job that runs out of work part way through a tick
+ * on a fast core is credited with that instant.
+ */
+void print_capacity_stats(Process *processes, int process_count, CPU *cpus, int cpu_count) {
+    double total_capacity = 0.0;
+    sim_time_t makespan = 0;
+    int completed = 0;
+
+    printf("\nCapacity Statistics:\n");
+    printf("%-6s %-7s %-9s %-10s %-12s\n", "CPU ID", "Speed", "Busy Time", "Work Done", "Capacity Use");
+    printf("--------------------------------------------------\n");
+    for (int i = 0; i < cpu_count; i++) {
+        double capacity_use = 0.0;
+        sim_time_t cpu_total_time = cpus[i].busy_time + cpus[i].idle_time;
+        if (cpu_total_time > 0) {
+            capacity_use = 100.0 * cpus[i].work_done / (cpus[i].speed * cpu_total_time);
+        }
+        total_capacity += cpus[i].speed;
+        printf("%-6d %-7.2f %-9s %-10.2f %-11.2f%%\n",
+               cpus[i].id, cpus[i].speed, time_str(cpus[i].busy_time), time_to_double(cpus[i].work_done),
+               capacity_use);
+    }
+    printf("--------------------------------------------------\n");
+
+    for (int i = 0; i < process_count; i++) {
+        Process *p = &processes[i];
+        if (p->finish_time == TIME_UNSET) continue;
+        if (p->finish_time > makespan) makespan = p->finish_time;
+        completed++;
+    }
+
+    printf("  Total Capacity:          %.2f baseline CPU(s)\n", total_capacity);
+    if (completed > 0 && makespan > 0) {
+        double span = time_to_double(makespan);
+        printf("  Makespan:                %s\n", time_str(makespan));
+        printf("  Throughput:              %.4f processes/tick\n", completed / span);
+        printf("  Throughput per Capacity: %.4f\n", completed / span / total_capacity);
+    }
+}
+
+/**
+ * Print the cost of strict co-scheduling under GANG scheduling
+ */
+void print_gang_stats(const GangTable *gangs, CPU *cpus, int cpu_count) {
+    int largest = 0;
+    sim_time_t cpu_time = 0;
+    for (int g = 0; g < gangs->gang_count; g++) {
+        if (gangs->gangs[g].member_count > largest) largest = gangs->gangs[g].member_count;
+    }
+    for (int c = 0; c < cpu_count; c++) cpu_time += cpus[c].busy_time + cpus[c].idle_time;
+
+    printf("\nGang Statistics:\n");
+    printf("  Gangs:                   %d (largest has %d member%s)\n",
+           gangs->gang_count, largest, largest == 1 ? "" : "s");
+    printf("  Fragmentation:           %s CPU time units (%.2f%% of CPU time)\n",
+           time_str(gangs->fragmentation), cpu_time > 0 ? 100.0 * gangs->fragmentation / cpu_time : 0.0);
+    printf("  Idle Waste:              %s CPU time units (%.2f%% of CPU time)\n",
+           time_str(gangs->idle_waste), cpu_time > 0 ? 100.0 * gangs->idle_waste / cpu_time : 0.0);
+}
+
+/**
+ * Print deadline misses and schedulability for traces with real-time jobs
+ */
+void print_realtime_stats(const RealTimeSummary *summary) {
+    printf("\nReal-Time Statistics:\n");
+    if (summary->tasks > 0) {
+        printf("  Periodic Tasks:          %d (utilization %.2f, density %.2f)\n",
+               summary->tasks, summary->utilization, summary->density);
+        printf("  EDF Bound (sufficient):  %.2f <= %.2f: %s\n", summary->density, summary->edf_bound,
+               summary->density <= summary->edf_bound ? "schedulable" : "not guaranteed");
+        printf("  RM Bound (sufficient):   %.2f <= %.2f: %s\n", summary->density, summary->rm_bound,
+               summary->density <= summary->rm_bound ? "schedulable" : "not guaranteed");
+    }
+    printf("  Jobs with Deadlines:     %d\n", summary->jobs);
+    printf("  Deadline Misses:         %d (%.2f%%)\n", summary->misses,
+           summary->jobs > 0 ? 100.0 * summary->misses / summary->jobs : 0.0);
+    printf("  Max Lateness:            %s\n", time_str(summary->max_lateness));
+}
+
+/**
+ * Generate CSV output for automated testing
+ */
+void print_csv_output(Process *processes, int process_count, CPU *cpus, int cpu_count, const GangTable *gangs) {
+    OutputBuffer out;
+    init_output_buffer(&out, OUTPUT_BASE_BYTES + (size_t)process_count * OUTPUT_BYTES_PER_PROCESS);
+    write_csv_output(&out, processes, process_count, cpus, cpu_count, gangs);
+    flush_output_buffer(&out, stdout);
+    cleanup_output_buffer(&out);
+}
+
+/**
+ * Append the CSV results section to an output buffer
+ */
+void write_csv_output(OutputBuffer *out, Process *processes, int process_count, CPU *cpus, int cpu_count,
+                      const GangTable *gangs) {
+    output_printf(out, "\n\n--- CSV Output ---\n");
+    
+    // Process stats CSV
+    output_printf(out, "\nProcess Stats (CSV):\n");
+    output_printf(out, "PID,Arrival,Burst,Priority,Start,Finish,Turnaround,Waiting,Response\n");
+    for (int i = 0; i < process_count; i++) {
+        Process *p = &processes[i];
+        if (p->finish_time != TIME_UNSET) {
+            sim_time_t turnaround = p->finish_time - p->arrival_time;
+            sim_time_t waiting = turnaround - p->burst_time;
+            if (waiting < 0) waiting = 0;
+            output_printf(out, "%d,%s,%s,%d,%s,%s,%s,%s,%s\n",
+                          p->pid, time_str(p->arrival_time), time_str(p->burst_time), p->priority,
+                          time_str(p->start_time), time_str(p->finish_time), time_str(turnaround),
+                          time_str(waiting), time_str(p->response_time));
+        } else {
+            output_printf(out, "%d,%s,%s,%d,%s,%s,%s,%s,%s\n",
+                          p->pid, time_str(p->arrival_time), time_str(p->burst_time), p->priority,
+                          "N/A", "N/A", "N/A", "N/A", "N/A");
+        }
+    }
+
+    // CPU stats CSV
+    output_printf(out, "\nCPU Stats (CSV):\n");
+    output_printf(out, "CPU_ID,BusyTime,IdleTime,Utilization%%\n");
+    for (int i = 0; i < cpu_count; i++) {
+        double utilization = 0.0;
+        sim_time_t cpu_total_time = cpus[i].busy_time + cpus[i].idle_time;
+        if (cpu_total_time > 0) {
+            utilization = 100.0 * cpus[i].busy_time / cpu_total_time;
+        }
+        output_printf(out, "%d,%s,%s,%.2f\n", cpus[i].id, time_str(cpus[i].busy_time),
+                      time_str(cpus[i].idle_time), utilization);
+    }
+
+    // Average stats CSV
+    SimSummary summary;
+    summarize_results(processes, process_count, cpus, cpu_count, &summary);
+
+    output_printf(out, "\nAverage Stats (CSV):\n");
+    output_printf(out, "AvgTurnaround,AvgWaiting,AvgResponse\n");
+    if (summary.completed > 0) {
+        output_printf(out, "%.2f,%.2f,%.2f\n", summary.avg_turnaround, summary.avg_waiting, summary.avg_response);
+    } else {
+        output_printf(out, "N/A,N/A,N/A\n");
+    }
+
+    // Capacity stats CSV (only for heterogeneous CPUs)
+    if (has_heterogeneous_cpus(cpus, cpu_count)) {
+        output_printf(out, "\nCapacity Stats (CSV):\n");
+        output_printf(out, "CPU_ID,Speed,WorkDone\n");
+        for (int i = 0; i < cpu_count; i++) {
+            output_printf(out, "%d,%.2f,%s\n", cpus[i].id, cpus[i].speed, time_str(cpus[i].work_done));
+        }
+    }
+
+    // Gang stats CSV (only for GANG scheduling)
+    if (gangs) {
+        output_printf(out, "\nGang Stats (CSV):\n");
+        output_printf(out, "Gangs,Fragmentation,IdleWaste\n");
+        output_printf(out, "%d,%s,%s\n", gangs->gang_count, time_str(gangs->fragmentation),
+                      time_str(gangs->idle_waste));
+    }
+
+    // Real-time stats CSV (only for traces with deadlines or periods)
+    RealTimeSummary realtime;
+    summarize_realtime(processes, process_count, cpu_count, &realtime);
+    if (realtime.jobs > 0 || realtime.tasks > 0) {
+        output_printf(out, "\nReal-Time Stats (CSV):\n");
+        output_printf(out, "Tasks,Utilization,Density,Jobs,Misses,MissRatio,MaxLateness,EDFGuaranteed,RMGuaranteed\n");
+        output_printf(out, "%d,%.4f,%.4f,%d,%d,%.4f,%s,%d,%d\n", realtime.tasks, realtime.utilization,
+                      realtime.density, realtime.jobs, realtime.misses,
+                      realtime.jobs > 0 ? (double)realtime.misses / realtime.jobs : 0.0,
+                      time_str(realtime.max_lateness), realtime.density <= realtime.edf_bound,
+                      realtime.density <= realtime.rm_bound);
+    }
+    output_printf(out, "--- End CSV Output ---\n");
+}
+
+/**
+ * Append time 't' as a JSON number, or null if unset
+ */
+static void output_json_time(OutputBuffer *out, const char *key, sim_time_t t, const char *separator) {
+    if (t == TIME_UNSET) output_printf(out, "\"%s\":null%s", key, separator);
+    else output_printf(out, "\"%s\":%s%s", key, time_str(t), separator);
+}
+
+/**
+ * Append the results as one JSON document
+ *
+ * Times are numbers in ticks; values of unfinished processes are null.
+ */
+void write_json_output(OutputBuffer *out, Process *processes, int process_count, CPU *cpus, int cpu_count,
+                       const SimConfig *config, sim_time_t total_time, const GangTable *gangs) {
+    SimSummary summary;
+    summarize_results(processes, process_count, cpus, cpu_count, &summary);
+
+    output_printf(out, "{\"algorithm\":\"%s\",\"cpus\":%d,", algorithm_name(config->algorithm), cpu_count);
+    output_json_time(out, "quantum", config->time_quantum, ",");
+    output_json_time(out, "total_time", total_time, ",");
+
+    output_printf(out, "\"processes\":[");
+    for (int i = 0; i < process_count; i++) {
+        Process *p = &processes[i];
+        bool finished = p->finish_time != TIME_UNSET;
+        sim_time_t turnaround = finished ? p->finish_time - p->arrival_time : TIME_UNSET;
+        sim_time_t waiting = finished ? turnaround - p->burst_time : TIME_UNSET;
+        if (finished && waiting < 0) waiting = 0;
+
+        output_printf(out, "%s{\"pid\":%d,", i > 0 ? "," : "", p->pid);
+        output_json_time(out, "arrival", p->arrival_time, ",");
+        output_json_time(out, "burst", p->burst_time, ",");
+        output_printf(out, "\"priority\":%d,", p->priority);
+        output_json_time(out, "start", finished ? p->start_time : TIME_UNSET, ",");
+        output_json_time(out, "finish", p->finish_time, ",");
+        output_json_time(out, "turnaround", turnaround, ",");
+        output_json_time(out, "waiting", waiting, ",");
+        output_json_time(out, "response", finished ? p->response_time : TIME_UNSET, "}");
+    }
+
+    output_printf(out, "],\"cpu_stats\":[");
+    for (int c = 0; c < cpu_count; c++) {
+        sim_time_t cpu_total_time = cpus[c].busy_time + cpus[c].idle_time;
+        output_printf(out, "%s{\"id\":%d,\"speed\":%.2f,", c > 0 ? "," : "", cpus[c].id, cpus[c].speed);
+        output_json_time(out, "busy", cpus[c].busy_time, ",");
+        output_json_time(out, "idle", cpus[c].idle_time, ",");
+        output_json_time(out, "work_done", cpus[c].work_done, ",");
+        output_printf(out, "\"utilization\":%.2f}",
+                      cpu_total_time > 0 ? 100.0 * cpus[c].busy_time / cpu_total_time : 0.0);
+    }
+    output_printf(out, "],");
+
+    if (summary.completed > 0) {
+        output_printf(out, "\"average\":{\"completed\":%d,\"turnaround\":%.2f,\"waiting\":%.2f,"
+                      "\"response\":%.2f}", summary.completed, summary.avg_turnaround, summary.avg_waiting,
+                      summary.avg_response);
+    } else {
+        output_printf(out, "\"average\":null");
+    }
+
+    if (gangs) {
+        output_printf(out, ",\"gang\":{\"gangs\":%d,", gangs->gang_count);
+        output_json_time(out, "fragmentation", gangs->fragmentation, ",");
+        output_json_time(out, "idle_waste", gangs->idle_waste, "}");
+    }
+
+    RealTimeSummary realtime;
+    summarize_realtime(processes, process_count, cpu_count, &realtime);
+    if (realtime.jobs > 0 || realtime.tasks > 0) {
+        output_printf(out, ",\"realtime\":{\"tasks\":%d,\"utilization\":%.4f,\"density\":%.4f,\"jobs\":%d,"
+                      "\"misses\":%d,", realtime.tasks, realtime.utilization, realtime.density, realtime.jobs,
+                      realtime.misses);
+        output_json_time(out, "max_lateness", realtime.max_lateness, ",");
+        output_printf(out, "\"edf_guaranteed\":%s,\"rm_guaranteed\":%s}",
+                      realtime.density <= realtime.edf_bound ? "true" : "false",
+                      realtime.density <= realtime.rm_bound ? "true" : "false");
+    }
+    output_printf(out, "}\n");
+}
+
+/**
+ * Append the results as fixed-layout binary records (see BinaryHeader)
+ */
+void write_binary_output(OutputBuffer *out, Process *processes, int process_count, CPU *cpus, int cpu_count,
+                         const SimConfig *config, sim_time_t total_time, const GangTable *gangs) {
+    BinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+    header.version = BINARY_VERSION;
+    header.algorithm = (uint32_t)config->algorithm;
+    header.process_count = (uint32_t)process_count;
+    header.cpu_count = (uint32_t)cpu_count;
+    header.gang_count = gangs ? (uint32_t)gangs->gang_count : 0;
+    header.time_scale = TIME_SCALE;
+    header.total_time = total_time;
+    header.time_quantum = config->time_quantum;
+    header.fragmentation = gangs ? gangs->fragmentation : 0;
+    header.idle_waste = gangs ? gangs->idle_waste : 0;
+    output_write(out, &header, sizeof(header));
+
+    for (int i = 0; i < process_count; i++) {
+        BinaryProcessRecord record;
+        record.pid = processes[i].pid;
+        record.priority = processes[i].priority;
+        record.arrival_time = processes[i].arrival_time;
+        record.burst_time = processes[i].burst_time;
+        record.start_time = processes[i].start_time;
+        record.finish_time = processes[i].finish_time;
+        record.response_time = processes[i].response_time;
+        output_write(out, &record, sizeof(record));
+    }
+
+    for (int c = 0; c < cpu_count; c++) {
+        BinaryCpuRecord record;
+        record.id = cpus[c].id;
+        record.reserved = 0;
+        record.busy_time = cpus[c].busy_time;
+        record.idle_time = cpus[c].idle_time;
+        record.work_done = cpus[c].work_done;
+        record.speed = cpus[c].speed;
+        output_write(out, &record, sizeof(record));
+    }
+}
+
+/**
+ * Render results in a machine-readable format through one buffer and write them to stdout
+ */
+void emit_results(OutputFormat format, Process *processes, int process_count, CPU *cpus, int cpu_count,
+                  const SimConfig *config, sim_time_t total_time, const GangTable *gangs) {
+    OutputBuffer out;
+    init_output_buffer(&out, OUTPUT_BASE_BYTES + (size_t)process_count * OUTPUT_BYTES_PER_PROCESS);
+    switch (format) {
+        case FORMAT_JSON:
+            write_json_output(&out, processes, process_count, cpus, cpu_count, config, total_time, gangs);
+            break;
+        case FORMAT_BINARY:
+            write_binary_output(&out, processes, process_count, cpus, cpu_count, config, total_time, gangs);
+            break;
+        case FORMAT_CSV:
+        case FORMAT_TEXT:
+            write_csv_output(&out, processes, process_count, cpus, cpu_count, gangs);
+            break;
+    }
+    flush_output_buffer(&out, stdout);
+    cleanup_output_buffer(&out);
+}
+
+/**
+ * Compute the headline metrics of a finished run
+ *
+ * Averages cover completed processes only; cpus may be NULL when utilization
+ * is not needed.
+ */
+void summarize_results(const Process *processes, int process_count, const CPU *cpus, int cpu_count,
+                       SimSummary *summary) {
+    double total_turnaround = 0.0, total_waiting = 0.0, total_response = 0.0;
+    sim_time_t busy = 0, cpu_time = 0;
+
+    summary->completed = 0;
+    summary->makespan = 0;
+    for (int i = 0; i < process_count; i++) {
+        const Process *p = &processes[i];
+        if (p->finish_time == TIME_UNSET) continue;
+        sim_time_t turnaround = p->finish_time - p->arrival_time;
+        sim_time_t waiting = turnaround - p->burst_time;
+        if (waiting < 0) waiting = 0;
+
+        total_turnaround += time_to_double(turnaround);
+        total_waiting += time_to_double(waiting);
+        total_response += time_to_double(p->response_time);
+        if (p->finish_time > summary->makespan) summary->makespan = p->finish_time;
+        summary->completed++;
+    }
+
+    int n = summary->completed > 0 ? summary->completed : 1;
+    summary->avg_turnaround = total_turnaround / n;
+    summary->avg_waiting = total_waiting / n;
+    summary->avg_response = total_response / n;
+
+    for (int c = 0; cpus && c < cpu_count; c++) {
+        busy += cpus[c].busy_time;
+        cpu_time += cpus[c].busy_time + cpus[c].idle_time;
+    }
+    summary->utilization = cpu_time > 0 ? 100.0 * busy / cpu_time : 0.0;
+}
+
+/**
+ * Display all simulation results
+ */
+void print_results(Process *processes, int process_count, CPU *cpus, int cpu_count, const Timeline *timeline,
+                   sim_time_t total_time, const GangTable *gangs, const TimelineView *view) {
+    printf("\n--- Simulation Results ---\n");
+
+    // Print visual timeline
+    sim_time_t to = view->to < total_time ? view->to : total_time;
+    print_timeline(timeline, view->from, to, processes, process_count, cpu_count);
+    print_process_stats(processes, process_count);
+    print_cpu_stats(cpus, cpu_count);
+    print_average_stats(processes, process_count, cpus, cpu_count);
+    if (has_heterogeneous_cpus(cpus, cpu_count)) {
+        print_capacity_stats(processes, process_count, cpus, cpu_count);
+    }
+    if (gangs) print_gang_stats(gangs, cpus, cpu_count);
+    RealTimeSummary realtime;
+    summarize_realtime(processes, process_count, cpu_count, &realtime);
+    if (realtime.jobs > 0 || realtime.tasks > 0) print_realtime_stats(&realtime);
+    
+    // Print CSV output for automated testing
+    print_csv_output(processes, process_count, cpus, cpu_count, gangs);
+}
+
+/************************* QUANTUM OPTIMIZER *************************/
+
+/**
+ * Get the objective name as a string
+ */
+const char *objective_name(Objective objective) {
+    switch (objective) {
+        case OBJECTIVE_RESPONSE:   return "mean response time";
+        case OBJECTIVE_P99:        return "p99 response time";
+        case OBJECTIVE_TURNAROUND: return "mean turnaround time";
+        case OBJECTIVE_WAITING:    return "mean waiting time";
+        default:                   return "unknown objective";
+    }
+}
+
+/**
+ * Count dispatches of a process onto a CPU in a recorded run
+ *
+ * Consecutive steps of one process on one CPU are merged into a single
+ * segment, so every busy segment starts with a context switch.
+ */
+int count_context_switches(const Timeline *timeline) {
+    int switches = 0;
+    TimelineReader reader;
+    seek_timeline(&reader, timeline, 0, TIME_NEVER);
+    for (const TimelineSegment *segment; (segment = next_timeline_segment(&reader)) != NULL; ) {
+        if (segment->pid != -1) switches++;
+    }
+    close_timeline_reader(&reader);
+    return switches;
+}
+
+static int compare_times(const void *a, const void *b) {
+    sim_time_t ta = *(const sim_time_t *)a;
+    sim_time_t tb = *(const sim_time_t *)b;
+    return (ta > tb) - (ta < tb);
+}
+
+/**
+ * Nearest-rank percentile (0-100) of completed processes' response times
+ *
+ * 'scratch' must hold process_count entries. Returns 0 if nothing completed.
+ */
+double response_percentile(const Process *processes, int process_count, sim_time_t *scratch, double percentile) {
+    int n = 0;
+    for (int i = 0; i < process_count; i++) {
+        if (processes[i].finish_time != TIME_UNSET) scratch[n++] = processes[i].response_time;
+    }
+    if (n == 0) return 0.0;
+
+    heap_sort(scratch, n, sizeof(sim_time_t), compare_times);
+    int rank = (int)ceil(percentile / 100.0 * n);
+    if (rank < 1) rank = 1;
+    return time_to_double(scratch[rank - 1]);
+}
+
+/**
+ * Simulate one quantum (reusing earlier trials) and return its objective value
+ */
+static double evaluate_quantum(SimContext *ctx, Process *processes, int process_count, const SimConfig *config,
+                               const OptimizerConfig *optimizer, sim_time_t quantum, sim_time_t *scratch,
+                               QuantumTrial *trials, int *trial_count) {
+    // The tick engine only sees whole-tick quanta
+    if (config->engine == ENGINE_TICK) {
+        quantum = (quantum + TIME_SCALE / 2) / TIME_SCALE * TIME_SCALE;
+        if (quantum < TIME_SCALE) quantum = TIME_SCALE;
+    }
+    for (int t = 0; t < *trial_count; t++) {
+        if (trials[t].quantum == quantum) return trials[t].objective;
+    }
+    if (*trial_count >= OPTIMIZER_MAX_TRIALS) return INFINITY;
+
+    SimConfig trial_config = *config;
+    trial_config.time_quantum = quantum;
+    if (run_simulation(ctx, processes, process_count, &trial_config) == TIME_UNSET) exit(EXIT_FAILURE);
+
+    QuantumTrial *trial = &trials[(*trial_count)++];
+    trial->quantum = quantum;
+    summarize_results(processes, process_count, ctx->cpus, ctx->cpu_count, &trial->summary);
+    trial->p99_response = response_percentile(processes, process_count, scratch, 99.0);
+    trial->context_switches = count_context_switches(&ctx->timeline);
+
+    double metric = 0.0;
+    switch (optimizer->objective) {
+        case OBJECTIVE_RESPONSE:   metric = trial->summary.avg_response; break;
+        case OBJECTIVE_P99:        metric = trial->p99_response; break;
+        case OBJECTIVE_TURNAROUND: metric = trial->summary.avg_turnaround; break;
+        case OBJECTIVE_WAITING:    metric = trial->summary.avg_waiting; break;
+    }
+    int completed = trial->summary.completed > 0 ? trial->summary.completed : 1;
+    trial->objective = metric + time_to_double(optimizer->switch_cost) * trial->context_switches / completed;
+    if (trial->summary.completed < process_count) trial->objective = INFINITY; // Stalled runs never win
+    return trial->objective;
+}
+
+static int compare_trials(const void *a, const void *b) {
+    const QuantumTrial *ta = (const QuantumTrial *)a;
+    const QuantumTrial *tb = (const QuantumTrial *)b;
+    return (ta->quantum > tb->quantum) - (ta->quantum < tb->quantum);
+}
+
+/**
+ * Search the time quantum that minimizes the chosen objective and report it
+ *
+ * The objective is not unimodal in general, so an evenly spaced coarse scan
+ * first locates the best region; golden-section search then refines the
+ * bracket around the best grid point down to OPTIMIZER_TOLERANCE. The trace
+ * is loaded once and every trial reuses one SimContext.
+ */
+void optimize_quantum(Process *processes, int process_count, int cpu_count, const SimConfig *config,
+                      const double *cpu_speeds, const OptimizerConfig *optimizer) {
+    QuantumTrial trials[OPTIMIZER_MAX_TRIALS];
+    int trial_count = 0;
+    sim_time_t lo = optimizer->min_quantum, hi = optimizer->max_quantum;
+
+    SimContext ctx;
+    init_sim_context(&ctx, process_count, cpu_count, cpu_speeds);
+    sim_time_t *scratch = (sim_time_t *)malloc(process_count * sizeof(sim_time_t));
+    if (!scratch) {
+        perror("Failed to allocate optimizer scratch");
+        exit(EXIT_FAILURE);
+    }
+
+    // Coarse scan
+    int best_point = 0;
+    double best = INFINITY;
+    double spacing = (double)(hi - lo) / (OPTIMIZER_GRID_POINTS - 1);
+    for (int g = 0; g < OPTIMIZER_GRID_POINTS; g++) {
+        sim_time_t quantum = lo + (sim_time_t)llround(g * spacing);
+        double value = evaluate_quantum(&ctx, processes, process_count, config, optimizer, quantum, scratch,
+                                        trials, &trial_count);
+        if (value < best) {
+            best = value;
+            best_point = g;
+        }
+    }
+
+    // Golden-section refinement between the best grid point's neighbours
+    double a = lo + (best_point > 0 ? best_point - 1 : 0) * spacing;
+    double b = lo + (best_point < OPTIMIZER_GRID_POINTS - 1 ? best_point + 1 : best_point) * spacing;
+    double x1 = b - GOLDEN_RATIO_CONJUGATE * (b - a);
+    double x2 = a + GOLDEN_RATIO_CONJUGATE * (b - a);
+    double f1 = evaluate_quantum(&ctx, processes, process_count, config, optimizer, (sim_time_t)llround(x1),
+                                 scratch, trials, &trial_count);
+    double f2 = evaluate_quantum(&ctx, processes, process_count, config, optimizer, (sim_time_t)llround(x2),
+                                 scratch, trials, &trial_count);
+    while (b - a > OPTIMIZER_TOLERANCE && trial_count < OPTIMIZER_MAX_TRIALS) {
+        if (f1 <= f2) {
+            b = x2;
+            x2 = x1;
+            f2 = f1;
+            x1 = b - GOLDEN_RATIO_CONJUGATE * (b - a);
+            f1 = evaluate_quantum(&ctx, processes, process_count, config, optimizer, (sim_time_t)llround(x1),
+                                  scratch, trials, &trial_count);
+        } else {
+            a = x1;
+            x1 = x2;
+            f1 = f2;
+            x2 = a + GOLDEN_RATIO_CONJUGATE * (b - a);
+            f2 = evaluate_quantum(&ctx, processes, process_count, config, optimizer, (sim_time_t)llround(x2),
+                                  scratch, trials, &trial_count);
+        }
+    }
+
+    // Report every trial in quantum order, then the winner (ties go to the smaller quantum)
+    heap_sort(trials, trial_count, sizeof(QuantumTrial), compare_trials);
+    const QuantumTrial *winner = &trials[0];
+    for (int t = 1; t < trial_count; t++) {
+        if (trials[t].objective < winner->objective) winner = &trials[t];
+    }
+
+    printf("\nOptimizing %s quantum on %d CPU(s) for %s", algorithm_name(config->algorithm), cpu_count,
+           objective_name(optimizer->objective));
+    if (optimizer->switch_cost > 0) printf(" + %s per context switch", time_str(optimizer->switch_cost));
+    printf("\nSearch range %s to %s, %d simulation(s)\n", time_str(lo), time_str(hi), trial_count);
+
+    printf("\n%-9s %-10s %-8s %-8s %-8s %-8s\n", "Quantum", "Objective", "AvgResp", "P99Resp", "AvgTurn", "Switches");
+    printf("------------------------------------------------------\n");
+    for (int t = 0; t < trial_count; t++) {
+        const QuantumTrial *trial = &trials[t];
+        printf("%-9s %-10.2f %-8.2f %-8.2f %-8.2f %-8d%s\n", time_str(trial->quantum), trial->objective,
+               trial->summary.avg_response, trial->p99_response, trial->summary.avg_turnaround,
+               trial->context_switches, trial == winner ? " <- best" : "");
+    }
+    printf("------------------------------------------------------\n");
+
+    printf("\nBest Quantum: %s\n", time_str(winner->quantum));
+    printf("  Objective:               %.2f\n", winner->objective);
+    printf("  Average Turnaround Time: %.2f\n", winner->summary.avg_turnaround);
+    printf("  Average Waiting Time:    %.2f\n", winner->summary.avg_waiting);
+    printf("  Average Response Time:   %.2f\n", winner->summary.avg_response);
+    printf("  P99 Response Time:       %.2f\n", winner->p99_response);
+    printf("  Context Switches:        %d\n", winner->context_switches);
+
+    printf("\nQuantum Search (CSV):\n");
+    printf("Quantum,Objective,AvgTurnaround,AvgWaiting,AvgResponse,P99Response,Switches,Best\n");
+    for (int t = 0; t < trial_count; t++) {
+        const QuantumTrial *trial = &trials[t];
+        printf("%s,%.4f,%.2f,%.2f,%.2f,%.2f,%d,%d\n", time_str(trial->quantum), trial->objective,
+               trial->summary.avg_turnaround, trial->summary.avg_waiting, trial->summary.avg_response,
+               trial->p99_response, trial->context_switches, trial == winner);
+    }
+
+    free(scratch);
+    cleanup_sim_context(&ctx);
+}
+
+/**
+ * Parse --quantum-range "lo,hi" or pick a default range for the trace
+ *
+ * The default spans 0.1 tick (1 tick with the tick engine) to the longest
+ * burst, beyond which RR degenerates into FCFS.
+ */
+void parse_quantum_range(const char *range, const Process *processes, int process_count, Engine engine,
+                         sim_time_t *lo, sim_time_t *hi) {
+    if (range) {
+        char lo_text[MAX_LINE_LENGTH], hi_text[MAX_LINE_LENGTH];
+        if (sscanf(range, "%255[^,],%255s", lo_text, hi_text) != 2 || !parse_time(lo_text, lo) ||
+            !parse_time(hi_text, hi) || *lo <= 0 || *hi < *lo) {
+            fprintf(stderr, "Error: Invalid quantum range '%s' (expected lo,hi with 0 < lo <= hi)\n", range);
+            exit(EXIT_FAILURE);
+        }
+        return;
+    }
+
+    *lo = (engine == ENGINE_TICK) ? TICKS(1) : TIME_SCALE / 10;
+    *hi = *lo;
+    for (int i = 0; i < process_count; i++) {
+        if (processes[i].burst_time > *hi) *hi = processes[i].burst_time;
+    }
+}
+
+/************************* QUEUEING MODELS *************************/
+
+/**
+ * Fit arrival and service moments of a trace and evaluate closed-form models
+ *
+ * Arrivals are summarized by the rate and SCV of their gaps, service by the
+ * mean and SCV of burst / mean_speed. With a = lambda * E[S] and rho = a / c:
+ *   M/M/c    Wq = C(c, a) * E[S] / (c - a), C from the Erlang B recurrence
+ *   M/G/1    Wq = lambda * E[S^2] / (2 c^2 (1 - rho)), one server c times as fast
+ *   Kingman  Wq = Wq(M/M/c) * (ca^2 + cs^2) / 2 (exact Kingman form when c = 1)
+ */
+void fit_queueing_model(const Process *processes, int process_count, int servers, double mean_speed,
+                        QueueingEstimate *estimate) {
+    memset(estimate, 0, sizeof(*estimate));
+    estimate->samples = process_count;
+    estimate->servers = servers;
+    estimate->mmc_wait = estimate->mg1_wait = estimate->kingman_wait = INFINITY;
+    if (process_count < 2 || servers < 1 || mean_speed <= 0.0) return;
+
+    sim_time_t *arrivals = (sim_time_t *)malloc(process_count * sizeof(sim_time_t));
+    if (!arrivals) {
+        perror("Failed to allocate queueing fit");
+        exit(EXIT_FAILURE);
+    }
+    double service_sum = 0.0, service_sq = 0.0;
+    for (int i = 0; i < process_count; i++) {
+        arrivals[i] = processes[i].arrival_time;
+        double service = time_to_double(processes[i].burst_time) / mean_speed;
+        service_sum += service;
+        service_sq += service * service;
+    }
+    heap_sort(arrivals, process_count, sizeof(sim_time_t), compare_times);
+
+    double gap_sum = 0.0, gap_sq = 0.0;
+    for (int i = 1; i < process_count; i++) {
+        double gap = time_to_double(arrivals[i] - arrivals[i - 1]);
+        gap_sum += gap;
+        gap_sq += gap * gap;
+    }
+    free(arrivals);
+
+    int n = process_count, gaps = process_count - 1;
+    double mean_gap = gap_sum / gaps;
+    estimate->mean_service = service_sum / n;
+    double service_var = service_sq / n - estimate->mean_service * estimate->mean_service;
+    if (estimate->mean_service > 0.0) {
+        estimate->service_scv = fmax(service_var, 0.0) / (estimate->mean_service * estimate->mean_service);
+    }
+    if (mean_gap <= 0.0) {
+        // Every job arrives at once: no steady state to model
+        estimate->arrival_rate = INFINITY;
+        estimate->utilization = INFINITY;
+        return;
+    }
+    double gap_var = gap_sq / gaps - mean_gap * mean_gap;
+    estimate->arrival_rate = 1.0 / mean_gap;
+    estimate->arrival_scv = fmax(gap_var, 0.0) / (mean_gap * mean_gap);
+
+    double c = servers;
+    double offered = estimate->arrival_rate * estimate->mean_service;
+    estimate->utilization = offered / c;
+    if (estimate->utilization >= 1.0) return;
+
+    // Erlang C via the numerically stable Erlang B recurrence
+    double erlang_b = 1.0;
+    for (int k = 1; k <= servers; k++) erlang_b = offered * erlang_b / (k + offered * erlang_b);
+    double erlang_c = erlang_b / (1.0 - estimate->utilization * (1.0 - erlang_b));
+
+    double second_moment = service_sq / n;
+    estimate->mmc_wait = erlang_c * estimate->mean_service / (c - offered);
+    estimate->mg1_wait = estimate->arrival_rate * second_moment / (2.0 * c * c * (1.0 - estimate->utilization));
+    estimate->kingman_wait = estimate->mmc_wait * (estimate->arrival_scv + estimate->service_scv) / 2.0;
+}
+
+static void print_model_row(const char *model, double utilization, double wait, double mean_service,
+                            const SimSummary *simulated) {
+    if (isinf(wait)) {
+        printf("  %-18s %6.1f%%  %12s  %14s\n", model, 100.0 * utilization, "unstable", "unstable");
+        return;
+    }
+    printf("  %-18s %6.1f%%  %12.2f  %14.2f", model, 100.0 * utilization, wait, wait + mean_service);
+    if (simulated && simulated->avg_waiting > 0.0) {
+        printf("  %+9.1f%%", 100.0 * (wait - simulated->avg_waiting) / simulated->avg_waiting);
+    }
+    printf("\n");
+}
+
+/**
+ * Print the fitted model and its estimates, next to the simulated averages if given
+ */
+void print_queueing_estimates(const QueueingEstimate *estimate, const SimSummary *simulated) {
+    printf("\nQueueing Model Estimates (%d CPU(s), lambda %.4f/tick, E[S] %.2f, ca^2 %.2f, cs^2 %.2f):\n",
+           estimate->servers, estimate->arrival_rate, estimate->mean_service, estimate->arrival_scv,
+           estimate->service_scv);
+    if (estimate->samples < 2 || isinf(estimate->arrival_rate)) {
+        printf("  Not enough distinct arrivals to fit an arrival process.\n");
+        return;
+    }
+    printf("  %-18s %7s  %12s  %14s%s\n", "Model", "Util", "Avg Waiting", "Avg Turnaround",
+           simulated ? "  Wait Error" : "");
+    if (simulated) {
+        printf("  %-18s %6.1f%%  %12.2f  %14.2f\n", "Simulated", simulated->utilization,
+               simulated->avg_waiting, simulated->avg_turnaround);
+    }
+    print_model_row("M/M/c", estimate->utilization, estimate->mmc_wait, estimate->mean_service, simulated);
+    print_model_row("M/G/1 (pooled)", estimate->utilization, estimate->mg1_wait, estimate->mean_service, simulated);
+    print_model_row("Kingman (G/G/c)", estimate->utilization, estimate->kingman_wait, estimate->mean_service,
+                    simulated);
 }
 
 /**
- * Update waiting times for all waiting processes
+ * Write the estimates as a CSV section (unstable models report "inf")
  */
-void update_waiting_times(Process *processes, int process_count, int current_time) {
-    // DONE: Implement waiting time tracking
-    //
-    // This function should:
-    // 1. Iterate through all processes
-    // 2. For each process that:
-    //    - Has arrived (arrival_time <= current_time), AND
-    //    - Is not completed (state != COMPLETED), AND
-    //    - Is not currently running on a CPU (state != RUNNING)
-    //    Increment its waiting_time by 1
-    //
-    // Hint: Waiting time is used to calculate performance metrics
-	
-	for (int i = 0; i < process_count; i++) {
-		if (processes[i].arrival_time <= current_time 
-			&& processes[i].state != COMPLETED
-			&& processes[i].state != RUNNING) {
-			
-			processes[i].waiting_time++;
-		}
-	}
+void write_queueing_csv(const QueueingEstimate *estimate) {
+    static const char *models[] = { "M/M/c", "M/G/1", "Kingman" };
+    const double waits[] = { estimate->mmc_wait, estimate->mg1_wait, estimate->kingman_wait };
+
+    printf("Model Estimates (CSV):\n");
+    printf("Model,ArrivalRate,MeanService,ArrivalSCV,ServiceSCV,Utilization,AvgWaiting,AvgTurnaround\n");
+    for (int m = 0; m < 3; m++) {
+        printf("%s,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f\n", models[m], estimate->arrival_rate,
+               estimate->mean_service, estimate->arrival_scv, estimate->service_scv, estimate->utilization,
+               waits[m], waits[m] + estimate->mean_service);
+    }
 }
 
+/************************* MONTE-CARLO REPLICATION *************************/
+
 /**
- * Execute processes on CPUs for the current time step
+ * splitmix64 step: a small, statistically sound generator with 64-bit state
  */
-// TODO process is not being set to completed correctly and process is not getting 
-// kicked out when its done
-void execute_processes(Process *processes, int process_count, CPU *cpus, int cpu_count, 
-                     int current_time, int *completed_count) {
-    // DONE: Implement CPU execution of processes for current time step
-    //
-    // This function should:
-    // 1. For each CPU:
-    //    a. If it has a process (current_process != NULL):
-    //       - Decrease the process's remaining_time by 1
-    //       - Increase the process's quantum_used by 1 (for RR)
-    //       - Increment the CPU's busy_time
-    //       - If remaining_time reaches 0:
-    //         * Mark process as COMPLETED
-    //         * Record finish_time as current_time + 1
-    //         * Set CPU's current_process to NULL
-    //         * Increment *completed_count
-    //    b. If it has no process:
-    //       - Increment the CPU's idle_time
-    //
-    // Note: processes and process_count parameters are not used in this implementation
-    (void)processes;
-    (void)process_count;
-
-	for (int i = 0; i < cpu_count; i++) {
-		Process *process = cpus[i].current_process;
+static uint64_t next_random(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
 
-		if (process != NULL) {
-			process->remaining_time--;
-			process->quantum_used++;  // only used by RR
-			cpus[i].busy_time++;
+/**
+ * Build replication 'replication' of the model trace into 'processes'
+ *
+ * Interarrival gaps and jobs (burst, priority, relative deadline) are drawn
+ * with replacement from the model trace, so each synthetic trace has the
+ * model's arrival and service distributions but its own random order. Groups
+ * and periods are dropped: resampled gangs could outgrow the machine. The
+ * stream depends only on the seed and replication number, never on the thread.
+ */
+void generate_synthetic_trace(const ReplicationJob *job, int replication, Process *processes) {
+    uint64_t state = job->seed ^ ((uint64_t)(replication + 1) * 0xD1B54A32D192ED03ULL);
+    sim_time_t arrival = job->first_arrival;
 
-			if (process->remaining_time <= 0) {
-				process->state = COMPLETED;	
-				process->finish_time = current_time + 1;
-				cpus[i].current_process = NULL;
-				(*completed_count)++;
-			}
-		} else {
-			cpus[i].idle_time++;
-		}
-	}
+    for (int i = 0; i < job->model_count; i++) {
+        if (i > 0 && job->gap_count > 0) arrival += job->gaps[next_random(&state) % job->gap_count];
+        const Process *model = &job->model[next_random(&state) % job->model_count];
+        Process *p = &processes[i];
+        p->pid = i + 1;
+        p->arrival_time = arrival;
+        p->burst_time = model->burst_time;
+        p->priority = model->priority;
+        p->group_id = -1;
+        p->deadline = (model->deadline != TIME_UNSET) ? arrival + (model->deadline - model->arrival_time) : TIME_UNSET;
+        p->period = 0;
+        p->job = 0;
+        reset_process(p);
+    }
 }
 
-/************************* MAIN SIMULATION *************************/
+/**
+ * Two-sided 95% critical value of Student's t distribution
+ */
+double student_t_975(int degrees_of_freedom) {
+    static const double table[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if (degrees_of_freedom < 1) return INFINITY;
+    if (degrees_of_freedom <= (int)(sizeof(table) / sizeof(table[0]))) return table[degrees_of_freedom - 1];
+    return 1.960 + 2.4 / degrees_of_freedom; // Within 0.002 of the exact value beyond 30
+}
 
 /**
- * Run the entire CPU scheduling simulation
+ * Mean and 95% CI half-width of each print_average_stats metric
  */
-void simulate(Process *processes, int process_count, int cpu_count, Algorithm algorithm, int time_quantum) {
-    // Initialize simulation components
-    ReadyQueue ready_queue_rr; 
-    init_queue(&ready_queue_rr);
+void estimate_metrics(const SimSummary *results, int count, MetricEstimate *estimates) {
+    static const char *names[REPLICATION_METRICS] = {
+        "Average Turnaround Time", "Average Waiting Time", "Average Response Time"
+    };
 
-    CPU *cpus = (CPU *)calloc(cpu_count, sizeof(CPU)); 
-    if (!cpus) {
-        perror("Failed to allocate CPUs");
+    for (int m = 0; m < REPLICATION_METRICS; m++) {
+        double sum = 0.0, sum_sq = 0.0;
+        for (int r = 0; r < count; r++) {
+            double value = m == 0 ? results[r].avg_turnaround : m == 1 ? results[r].avg_waiting
+                                                                       : results[r].avg_response;
+            sum += value;
+            sum_sq += value * value;
+        }
+        double mean = count > 0 ? sum / count : 0.0;
+        double variance = count > 1 ? (sum_sq - count * mean * mean) / (count - 1) : 0.0;
+        if (variance < 0.0) variance = 0.0; // Rounding on constant samples
+
+        estimates[m].name = names[m];
+        estimates[m].mean = mean;
+        estimates[m].half_width = count > 1 ? student_t_975(count - 1) * sqrt(variance / count) : INFINITY;
+    }
+}
+
+/**
+ * Worker thread: generate and simulate replications until the run is done
+ */
+static void *replication_worker(void *arg) {
+    ReplicationJob *job = (ReplicationJob *)arg;
+    Process *processes = (Process *)malloc(job->model_count * sizeof(Process));
+    if (!processes) {
+        perror("Failed to allocate synthetic trace");
         exit(EXIT_FAILURE);
     }
-    for (int i = 0; i < cpu_count; i++) cpus[i].id = i;
+    SimContext ctx;
+    init_sim_context(&ctx, job->model_count, job->cpu_count, job->cpu_speeds);
 
-    int timeline_capacity = INITIAL_TIMELINE_CAPACITY;
-    int **timeline = NULL;
-    init_timeline(&timeline, timeline_capacity, cpu_count);
+    pthread_mutex_lock(&job->lock);
+    for (;;) {
+        while (!job->done && job->next_rep >= job->round_end) pthread_cond_wait(&job->work_ready, &job->lock);
+        if (job->next_rep >= job->round_end) break;
+        int r = job->next_rep++;
+        pthread_mutex_unlock(&job->lock);
 
-    int current_time = 0;
-    int completed_count = 0;
-    
-    // Display simulation header
-    printf("\nStarting simulation with %s on %d CPU(s)%s\n", 
-           algorithm_name(algorithm),
-           cpu_count, 
-           algorithm == RR ? ", Quantum=" : "");
-    if (algorithm == RR) printf("%d", time_quantum);
-    printf("\n");
+        generate_synthetic_trace(job, r, processes);
+        run_simulation(&ctx, processes, job->model_count, job->config);
+        summarize_results(processes, job->model_count, ctx.cpus, ctx.cpu_count, &job->results[r]);
 
-    // Main Simulation Loop
-    while (completed_count < process_count) {
-        // TODO: Implement the simulation main loop
-        // 
-        // This is the framework for the simulation loop. You need to:
-        // 1. Handle new process arrivals via handle_arrivals()
-        // 2. For Round Robin: enqueue newly arrived processes and handle quantum expiry
-        // 3. For SRTF: check for preemptions
-        // 4. Assign processes to idle CPUs based on the scheduling algorithm
-        // 5. Update the timeline data structure
-        // 6. Update waiting times
-        // 7. Execute processes on CPUs
-        // 8. Advance time
+        pthread_mutex_lock(&job->lock);
+        if (++job->finished == job->round_end) pthread_cond_signal(&job->round_done);
+    }
+    pthread_mutex_unlock(&job->lock);
 
-        // Handle new process arrivals
-        int arrived_indices[MAX_PROCESSES];
-        int arrival_count = 0;
-        handle_arrivals(processes, process_count, current_time, algorithm, arrived_indices, &arrival_count);
+    cleanup_sim_context(&ctx);
+    free(processes);
+    return NULL;
+}
 
-        // Enqueue newly arrived processes for Round Robin
-        if (algorithm == RR) {
-            for (int i = 0; i < arrival_count; i++) {
-                enqueue(&ready_queue_rr, arrived_indices[i]);
-            }
-            handle_rr_quantum_expiry(processes, cpus, cpu_count, time_quantum, &ready_queue_rr, current_time);
-        }
+/**
+ * Simulate up to 'max_replications' synthetic versions of a trace in parallel
+ *
+ * Replications run in rounds of REPLICATION_ROUND. After each round the 95%
+ * confidence interval of every metric is checked and the run stops once all
+ * are narrower than 'ci_width' ticks (0 = always run every replication).
+ * Rounds do not depend on the thread count, so results are reproducible.
+ */
+void run_replications(const Process *model, int model_count, const SimConfig *config, int cpu_count,
+                      const double *cpu_speeds, int max_replications, uint64_t seed, double ci_width,
+                      int thread_count, OutputFormat format) {
+    if (thread_count <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = online > 0 ? (int)online : 1;
+    }
+    if (thread_count > max_replications) thread_count = max_replications;
 
-        // Handle SRTF preemption
-        if (algorithm == SRTF) {
-            handle_srtf_preemption(processes, process_count, cpus, cpu_count, current_time);
-        }
+    // Interarrival gaps of the model, from its arrivals in time order
+    sim_time_t *gaps = (sim_time_t *)malloc(model_count * sizeof(sim_time_t));
+    ReplicationJob job;
+    job.results = (SimSummary *)calloc(max_replications, sizeof(SimSummary));
+    pthread_t *threads = (pthread_t *)malloc(thread_count * sizeof(pthread_t));
+    if (!gaps || !job.results || !threads) {
+        perror("Failed to allocate replication state");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < model_count; i++) gaps[i] = model[i].arrival_time;
+    heap_sort(gaps, model_count, sizeof(sim_time_t), compare_times);
+    job.first_arrival = gaps[0];
+    for (int i = 0; i + 1 < model_count; i++) gaps[i] = gaps[i + 1] - gaps[i];
 
-        // Assign processes to idle CPUs
-        assign_processes_to_idle_cpus(processes, process_count, cpus, cpu_count, algorithm, 
-                                   &ready_queue_rr, current_time);
+    job.model = model;
+    job.model_count = model_count;
+    job.gaps = gaps;
+    job.gap_count = model_count - 1;
+    job.seed = seed;
+    job.config = config;
+    job.cpu_count = cpu_count;
+    job.cpu_speeds = cpu_speeds;
+    job.next_rep = 0;
+    job.round_end = 0;
+    job.finished = 0;
+    job.done = false;
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.work_ready, NULL);
+    pthread_cond_init(&job.round_done, NULL);
 
-        // Update timeline
-        if (current_time >= timeline_capacity) {
-            expand_timeline(&timeline, &timeline_capacity, timeline_capacity * 2, cpu_count);
-        }
-        for (int c = 0; c < cpu_count; c++) {
-            timeline[current_time][c] = (cpus[c].current_process != NULL) ? cpus[c].current_process->pid : -1;
+    for (int i = 0; i < thread_count; i++) {
+        if (pthread_create(&threads[i], NULL, replication_worker, &job) != 0) {
+            perror("Failed to start replication worker");
+            exit(EXIT_FAILURE);
         }
+    }
 
-        // Update waiting times for processes
-        update_waiting_times(processes, process_count, current_time);
+    MetricEstimate estimates[REPLICATION_METRICS];
+    bool converged = false;
+    int completed = 0;
+    while (completed < max_replications && !converged) {
+        pthread_mutex_lock(&job.lock);
+        job.round_end = completed + REPLICATION_ROUND < max_replications ? completed + REPLICATION_ROUND
+                                                                         : max_replications;
+        pthread_cond_broadcast(&job.work_ready);
+        while (job.finished < job.round_end) pthread_cond_wait(&job.round_done, &job.lock);
+        completed = job.finished;
+        pthread_mutex_unlock(&job.lock);
 
-        // Execute processes on CPUs
-        execute_processes(processes, process_count, cpus, cpu_count, current_time, &completed_count);
+        estimate_metrics(job.results, completed, estimates);
+        if (ci_width > 0.0) {
+            converged = true;
+            for (int m = 0; m < REPLICATION_METRICS; m++) {
+                if (2.0 * estimates[m].half_width > ci_width) converged = false;
+            }
+        }
+    }
 
-        // Advance time
-        current_time++;
+    pthread_mutex_lock(&job.lock);
+    job.done = true;
+    pthread_cond_broadcast(&job.work_ready);
+    pthread_mutex_unlock(&job.lock);
+    for (int i = 0; i < thread_count; i++) pthread_join(threads[i], NULL);
+    pthread_cond_destroy(&job.round_done);
+    pthread_cond_destroy(&job.work_ready);
+    pthread_mutex_destroy(&job.lock);
 
-        // Safety break to prevent infinite loops
-        if (current_time > timeline_capacity * 5 && completed_count < process_count) {
-            fprintf(stderr, "Warning: Simulation exceeded maximum expected time. Aborting.\n");
-            break;
+    if (format == FORMAT_CSV) {
+        printf("Replication Stats (CSV):\n");
+        printf("Metric,Mean,CILow,CIHigh,Replications\n");
+        for (int m = 0; m < REPLICATION_METRICS; m++) {
+            printf("%s,%.4f,%.4f,%.4f,%d\n", estimates[m].name, estimates[m].mean,
+                   estimates[m].mean - estimates[m].half_width, estimates[m].mean + estimates[m].half_width,
+                   completed);
+        }
+    } else if (format == FORMAT_JSON) {
+        printf("{\"algorithm\":\"%s\",\"replications\":%d,\"converged\":%s,\"metrics\":[",
+               algorithm_name(config->algorithm), completed, converged ? "true" : "false");
+        for (int m = 0; m < REPLICATION_METRICS; m++) {
+            printf("%s{\"name\":\"%s\",\"mean\":%.4f,\"ci_low\":%.4f,\"ci_high\":%.4f}", m > 0 ? "," : "",
+                   estimates[m].name, estimates[m].mean, estimates[m].mean - estimates[m].half_width,
+                   estimates[m].mean + estimates[m].half_width);
+        }
+        printf("]}\n");
+    } else {
+        printf("\nMonte-Carlo Replication (%s, %d CPU(s), %d synthetic processes, seed %" PRIu64 "):\n",
+               algorithm_name(config->algorithm), cpu_count, model_count, seed);
+        printf("%-24s %10s   %s\n", "Metric", "Mean", "95% Confidence Interval");
+        printf("----------------------------------------------------------\n");
+        for (int m = 0; m < REPLICATION_METRICS; m++) {
+            printf("%-24s %10.2f   [%8.2f, %8.2f]\n", estimates[m].name, estimates[m].mean,
+                   estimates[m].mean - estimates[m].half_width, estimates[m].mean + estimates[m].half_width);
+        }
+        if (ci_width > 0.0) {
+            printf("%d replication(s): %s target CI width %.2f\n", completed,
+                   converged ? "reached" : "did not reach", ci_width);
+        } else {
+            printf("%d replication(s)\n", completed);
         }
     }
 
-    int total_time = current_time; // Record total simulation time
-    print_results(processes, process_count, cpus, cpu_count, timeline, total_time);
-
-    // Cleanup
-    cleanup_timeline(timeline, timeline_capacity);
-    free(cpus);
+    free(threads);
+    free(job.results);
+    free(gaps);
 }
 
-/************************* RESULTS DISPLAY *************************/
+/************************* BATCH MODE *************************/
+
+static int compare_paths(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
 
 /**
- * Print the execution timeline visualization
+ * Append a copy of 'path' to a growable path list
  */
-void print_timeline(int **timeline, int total_time, Process *processes, int process_count, int cpu_count) {
-    printf("\nExecution Timeline:\n");
-    int time_units_per_line = (TIMELINE_WIDTH - 5) / TIME_UNIT_WIDTH;
-    if (time_units_per_line <= 0) time_units_per_line = 1; // Ensure at least 1 unit per line
-    int time_segments = (total_time + time_units_per_line - 1) / time_units_per_line;
-
-    // Print color key
-    printf("\nColor Key:\n");
-    for (int i = 0; i < process_count; i++) {
-        printf("%sPID %-2d%s ", get_color_for_pid(processes[i].pid), processes[i].pid, COLOR_RESET);
-        if ((i + 1) % 8 == 0 && i + 1 < process_count) printf("\n");
+static void append_path(char ***paths, int *count, int *capacity, const char *path) {
+    if (*count == *capacity) {
+        *capacity = *capacity > 0 ? *capacity * 2 : 64;
+        char **grown = (char **)realloc(*paths, *capacity * sizeof(char *));
+        if (!grown) {
+            perror("Failed to allocate trace list");
+            exit(EXIT_FAILURE);
+        }
+        *paths = grown;
     }
-    printf("\n");
+    size_t length = strlen(path) + 1;
+    (*paths)[*count] = (char *)malloc(length);
+    if (!(*paths)[*count]) {
+        perror("Failed to allocate trace path");
+        exit(EXIT_FAILURE);
+    }
+    memcpy((*paths)[*count], path, length);
+    (*count)++;
+}
 
-    // Print timeline in segments
-    for (int segment = 0; segment < time_segments; segment++) {
-        int start_t = segment * time_units_per_line;
-        int end_t = start_t + time_units_per_line;
-        if (end_t > total_time) end_t = total_time;
+/**
+ * Collect the traces named by a batch source
+ *
+ * A directory contributes every regular file in it (hidden files skipped),
+ * sorted by name. Any other file is a manifest: one trace path per line,
+ * '#' comments allowed, relative paths resolved against the manifest's directory.
+ * Returns a malloc'd array of malloc'd paths.
+ */
+char **list_batch_traces(const char *source, int *count) {
+    char **paths = NULL;
+    int capacity = 0;
+    char path[MAX_PATH_LENGTH];
+    struct stat info;
+    *count = 0;
 
-        printf("\nTime %d to %d:\n", start_t, end_t - 1);
+    if (stat(source, &info) != 0) {
+        perror("Error opening batch source");
+        exit(EXIT_FAILURE);
+    }
 
-        // Time markers
-        printf("Time: ");
-        for (int t = start_t; t < end_t; t++) {
-            printf("%-5d", t); // Print time marker for each unit
+    if (S_ISDIR(info.st_mode)) {
+        DIR *dir = opendir(source);
+        if (!dir) {
+            perror("Error opening trace directory");
+            exit(EXIT_FAILURE);
         }
-        printf("\n");
-
-        // CPU timelines
-        for (int c = 0; c < cpu_count; c++) {
-            printf("CPU%-2d ", c);
-            for (int t = start_t; t < end_t; t++) {
-                int pid = timeline[t][c];
-                if (pid == -1) {
-                    printf("%-*s", TIME_UNIT_WIDTH, "."); // Idle marker
-                } else {
-                    printf("%s%-*d%s", get_color_for_pid(pid), TIME_UNIT_WIDTH, pid, COLOR_RESET);
-                }
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (entry->d_name[0] == '.') continue;
+            snprintf(path, sizeof(path), "%s/%s", source, entry->d_name);
+            if (stat(path, &info) == 0 && S_ISREG(info.st_mode)) {
+                append_path(&paths, count, &capacity, path);
             }
-            printf("\n");
         }
+        closedir(dir);
+        qsort(paths, *count, sizeof(char *), compare_paths);
+        return paths;
     }
-}
-
-/**
- * Print detailed process statistics
- */
-void print_process_stats(Process *processes, int process_count) {
-    printf("\nProcess Statistics:\n");
-    printf("%-6s %-7s %-7s %-7s %-7s %-7s %-7s %-7s\n",
-           "PID", "Arrival", "Burst", "Start", "Finish", "Turn.", "Waiting", "Resp.");
-    printf("----------------------------------------------------------------\n");
 
-    for (int i = 0; i < process_count; i++) {
-        Process *p = &processes[i];
-        if (p->finish_time != -1) { // Only calculate for completed processes
-            int turnaround = p->finish_time - p->arrival_time;
-            int waiting = turnaround - p->burst_time;
-            if (waiting < 0) waiting = 0; // Cannot be negative
+    FILE *manifest = fopen(source, "r");
+    if (!manifest) {
+        perror("Error opening batch manifest");
+        exit(EXIT_FAILURE);
+    }
+    const char *slash = strrchr(source, '/');
+    int dir_length = slash ? (int)(slash - source) : 0;
 
-            printf("%-6d %-7d %-7d %-7d %-7d %-7d %-7d %-7d\n",
-                   p->pid, p->arrival_time, p->burst_time,
-                   p->start_time, p->finish_time, turnaround, waiting, p->response_time);
+    char line[MAX_PATH_LENGTH];
+    while (fgets(line, sizeof(line), manifest)) {
+        char *name = line + strspn(line, " \t");
+        name[strcspn(name, "\r\n")] = '\0';
+        if (name[0] == '\0' || name[0] == '#') continue;
+        if (name[0] == '/' || !slash) {
+            snprintf(path, sizeof(path), "%s", name);
         } else {
-            printf("%-6d %-7d %-7d %-7s %-7s %-7s %-7s %-7s\n",
-                   p->pid, p->arrival_time, p->burst_time,
-                   (p->start_time == -1 ? "N/A" : "-"), "N/A", "N/A", "N/A",
-                   (p->response_time == -1 ? "N/A" : "-"));
+            snprintf(path, sizeof(path), "%.*s/%s", dir_length, source, name);
         }
+        append_path(&paths, count, &capacity, path);
     }
-    printf("----------------------------------------------------------------\n");
+    fclose(manifest);
+    return paths;
 }
 
 /**
- * Print CPU usage statistics
+ * Map a trace file and parse it into a reusable process buffer
+ *
+ * The buffer grows as needed. Returns the process count, or -1 with
+ * *error set if the file cannot be read.
  */
-void print_cpu_stats(CPU *cpus, int cpu_count) {
-    printf("\nCPU Statistics:\n");
-    printf("%-6s %-9s %-9s %-12s\n", "CPU ID", "Busy Time", "Idle Time", "Utilization");
-    printf("------------------------------------------\n");
-    for (int i = 0; i < cpu_count; i++) {
-        double utilization = 0.0;
-        int cpu_total_time = cpus[i].busy_time + cpus[i].idle_time;
-        if (cpu_total_time > 0) {
-            utilization = 100.0 * cpus[i].busy_time / cpu_total_time;
+static int load_mapped_trace(const char *path, Process **buffer, int *capacity, const char **error) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        *error = "cannot open";
+        return -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        *error = "cannot stat";
+        return -1;
+    }
+    if (info.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+
+    size_t length = (size_t)info.st_size;
+    const char *data = (const char *)mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        *error = "cannot map";
+        return -1;
+    }
+
+    int count = parse_trace_buffer(data, length, *buffer, *capacity);
+    if (count > *capacity) {
+        Process *grown = (Process *)realloc(*buffer, count * sizeof(Process));
+        if (!grown) {
+            perror("Failed to allocate processes");
+            exit(EXIT_FAILURE);
         }
-        printf("%-6d %-9d %-9d %-11.2f%%\n", cpus[i].id, cpus[i].busy_time, cpus[i].idle_time, utilization);
+        *buffer = grown;
+        *capacity = count;
+        parse_trace_buffer(data, length, *buffer, *capacity);
     }
-    printf("------------------------------------------\n");
+    munmap((void *)data, length);
+    return count;
 }
 
 /**
- * Print average performance metrics
+ * Batch worker: take traces off the shared job until none are left
+ *
+ * Each worker owns its process buffer and simulation context and grows them
+ * only when a trace is larger than any it has seen, so most traces run
+ * without allocating.
  */
-void print_average_stats(Process *processes, int process_count) {
-    double total_turnaround = 0.0, total_waiting = 0.0, total_response = 0.0;
-    int valid_stats_count = 0;
+static void *batch_worker(void *arg) {
+    BatchJob *job = (BatchJob *)arg;
+    Process *processes = NULL;
+    int process_capacity = 0;
+    SimContext ctx;
+    bool have_context = false;
 
-    for (int i = 0; i < process_count; i++) {
-        Process *p = &processes[i];
-        if (p->finish_time != -1) { // Only calculate for completed processes
-            int turnaround = p->finish_time - p->arrival_time;
-            int waiting = turnaround - p->burst_time;
-            if (waiting < 0) waiting = 0;
+    for (;;) {
+        pthread_mutex_lock(&job->lock);
+        int t = job->next_trace++;
+        pthread_mutex_unlock(&job->lock);
+        if (t >= job->trace_count) break;
 
-            total_turnaround += turnaround;
-            total_waiting += waiting;
-            total_response += p->response_time;
-            valid_stats_count++;
+        BatchResult *result = &job->results[t];
+        int count = load_mapped_trace(result->path, &processes, &process_capacity, &result->error);
+        if (count <= 0) {
+            if (count == 0) result->error = "no processes";
+            continue;
+        }
+        if (has_periodic_tasks(processes, count)) {
+            sim_time_t horizon = job->horizon != TIME_UNSET ? job->horizon : default_release_horizon(processes, count);
+            expand_periodic_tasks(&processes, &count, horizon);
+            process_capacity = count;
         }
-    }
 
-    if (valid_stats_count > 0) {
-        printf("\nAverage Statistics (for %d completed processes):\n", valid_stats_count);
-        printf("  Average Turnaround Time: %.2f\n", total_turnaround / valid_stats_count);
-        printf("  Average Waiting Time:    %.2f\n", total_waiting / valid_stats_count);
-        printf("  Average Response Time:   %.2f\n", total_response / valid_stats_count);
-    } else {
-        printf("\nNo processes completed. Cannot calculate average statistics.\n");
+        if (!have_context || ctx.process_capacity < count) {
+            if (have_context) cleanup_sim_context(&ctx);
+            init_sim_context(&ctx, process_capacity, job->cpu_count, job->cpu_speeds);
+            have_context = true;
+        }
+
+        result->process_count = count;
+        result->total_time = run_simulation(&ctx, processes, count, job->config);
+        if (result->total_time == TIME_UNSET) {
+            result->error = "gang larger than machine";
+            continue;
+        }
+        summarize_results(processes, count, ctx.cpus, ctx.cpu_count, &result->summary);
+        result->ok = true;
     }
+
+    if (have_context) cleanup_sim_context(&ctx);
+    free(processes);
+    return NULL;
 }
 
 /**
- * Generate CSV output for automated testing
+ * Simulate every trace on a pool of worker threads and write one results file
+ *
+ * Rows follow the order of 'paths', whatever order the workers finish in.
+ * thread_count 0 means one worker per online CPU.
  */
-void print_csv_output(Process *processes, int process_count, CPU *cpus, int cpu_count) {
-    printf("\n\n--- CSV Output ---\n");
-    
-    // Process stats CSV
-    printf("\nProcess Stats (CSV):\n");
-    printf("PID,Arrival,Burst,Priority,Start,Finish,Turnaround,Waiting,Response\n");
-    for (int i = 0; i < process_count; i++) {
-        Process *p = &processes[i];
-        if (p->finish_time != -1) {
-            int turnaround = p->finish_time - p->arrival_time;
-            int waiting = turnaround - p->burst_time;
-            if (waiting < 0) waiting = 0;
-            printf("%d,%d,%d,%d,%d,%d,%d,%d,%d\n",
-                   p->pid, p->arrival_time, p->burst_time, p->priority,
-                   p->start_time, p->finish_time, turnaround, waiting, p->response_time);
-        } else {
-             printf("%d,%d,%d,%d,%s,%s,%s,%s,%s\n",
-                   p->pid, p->arrival_time, p->burst_time, p->priority,
-                   "N/A", "N/A", "N/A", "N/A", "N/A");
-        }
+void run_batch(char **paths, int trace_count, const SimConfig *config, int cpu_count, const double *cpu_speeds,
+               sim_time_t horizon, int thread_count, const char *output_file) {
+    if (thread_count <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = online > 0 ? (int)online : 1;
     }
+    if (thread_count > trace_count) thread_count = trace_count > 0 ? trace_count : 1;
 
-    // CPU stats CSV
-    printf("\nCPU Stats (CSV):\n");
-    printf("CPU_ID,BusyTime,IdleTime,Utilization%%\n");
-    for (int i = 0; i < cpu_count; i++) {
-        double utilization = 0.0;
-        int cpu_total_time = cpus[i].busy_time + cpus[i].idle_time;
-        if (cpu_total_time > 0) {
-            utilization = 100.0 * cpus[i].busy_time / cpu_total_time;
-        }
-        printf("%d,%d,%d,%.2f\n", cpus[i].id, cpus[i].busy_time, cpus[i].idle_time, utilization);
+    BatchJob job;
+    job.paths = paths;
+    job.trace_count = trace_count;
+    job.next_trace = 0;
+    job.config = config;
+    job.cpu_count = cpu_count;
+    job.cpu_speeds = cpu_speeds;
+    job.horizon = horizon;
+    job.results = (BatchResult *)calloc(trace_count > 0 ? trace_count : 1, sizeof(BatchResult));
+    pthread_t *threads = (pthread_t *)malloc(thread_count * sizeof(pthread_t));
+    if (!job.results || !threads) {
+        perror("Failed to allocate batch state");
+        exit(EXIT_FAILURE);
     }
+    for (int t = 0; t < trace_count; t++) job.results[t].path = paths[t];
+    pthread_mutex_init(&job.lock, NULL);
 
-    // Average stats CSV
-    double total_turnaround = 0.0, total_waiting = 0.0, total_response = 0.0;
-    int valid_stats_count = 0;
-    for (int i = 0; i < process_count; i++) {
-        Process *p = &processes[i];
-        if (p->finish_time != -1) {
-            int turnaround = p->finish_time - p->arrival_time;
-            int waiting = turnaround - p->burst_time;
-            if (waiting < 0) waiting = 0;
-            
-            total_turnaround += turnaround;
-            total_waiting += waiting;
-            total_response += p->response_time;
-            valid_stats_count++;
+    for (int i = 0; i < thread_count; i++) {
+        if (pthread_create(&threads[i], NULL, batch_worker, &job) != 0) {
+            perror("Failed to start batch worker");
+            exit(EXIT_FAILURE);
         }
     }
+    for (int i = 0; i < thread_count; i++) pthread_join(threads[i], NULL);
+    pthread_mutex_destroy(&job.lock);
 
-    printf("\nAverage Stats (CSV):\n");
-    printf("AvgTurnaround,AvgWaiting,AvgResponse\n");
-    if (valid_stats_count > 0) {
-        printf("%.2f,%.2f,%.2f\n",
-               total_turnaround / valid_stats_count,
-               total_waiting / valid_stats_count,
-               total_response / valid_stats_count);
-    } else {
-        printf("N/A,N/A,N/A\n");
+    // Write all rows through one large stdio buffer
+    FILE *out = output_file ? fopen(output_file, "w") : stdout;
+    if (!out) {
+        perror("Error opening batch results file");
+        exit(EXIT_FAILURE);
     }
-    printf("--- End CSV Output ---\n");
-}
+    setvbuf(out, NULL, _IOFBF, BATCH_OUTPUT_BUFFER);
 
-/**
- * Display all simulation results
- */
-void print_results(Process *processes, int process_count, CPU *cpus, int cpu_count, int **timeline, int total_time) {
-    printf("\n--- Simulation Results ---\n");
+    int failed = 0;
+    fprintf(out, "Trace,Processes,Completed,TotalTime,AvgTurnaround,AvgWaiting,AvgResponse,Utilization%%,Status\n");
+    for (int t = 0; t < trace_count; t++) {
+        const BatchResult *r = &job.results[t];
+        if (r->ok) {
+            fprintf(out, "%s,%d,%d,%s,%.2f,%.2f,%.2f,%.2f,ok\n",
+                    r->path, r->process_count, r->summary.completed, time_str(r->total_time),
+                    r->summary.avg_turnaround, r->summary.avg_waiting, r->summary.avg_response,
+                    r->summary.utilization);
+        } else {
+            fprintf(out, "%s,%d,N/A,N/A,N/A,N/A,N/A,N/A,error: %s\n", r->path, r->process_count, r->error);
+            failed++;
+        }
+    }
+    if (out != stdout) fclose(out);
+    else fflush(out);
 
-    // Print visual timeline
-    print_timeline(timeline, total_time, processes, process_count, cpu_count);
-    print_process_stats(processes, process_count);
-    print_cpu_stats(cpus, cpu_count);
-    print_average_stats(processes, process_count);
-    
-    // Print CSV output for automated testing
-    print_csv_output(processes, process_count, cpus, cpu_count);
+    fprintf(stderr, "Batch: %d trace(s), %d failed, %d thread(s), %s on %d CPU(s)\n",
+            trace_count, failed, thread_count, algorithm_name(config->algorithm), cpu_count);
+
+    free(threads);
+    free(job.results);
 }
 
 /************************* MAIN FUNCTION *************************/
 
+#ifndef SCHEDULER_NO_MAIN
 int main(int argc, char *argv[]) {
-    Algorithm algorithm = FCFS;
-    int cpu_count = 1;
-    int time_quantum = DEFAULT_TIME_QUANTUM;
-    char *input_file = NULL;
+    Options options = {
+        .algorithm = FCFS,
+        .cpu_count = 1,
+        .time_quantum = TICKS(DEFAULT_TIME_QUANTUM),
+        .engine = ENGINE_EVENT,
+        .format = FORMAT_TEXT,
+        .objective = OBJECTIVE_RESPONSE,
+        .horizon = TIME_UNSET,
+        .seed = 1,
+        .window_to = TIME_NEVER,
+        .tick_ns = DEFAULT_IMPORT_TICK_NS,
+    };
 
     // Parse command line arguments
-    parse_arguments(argc, argv, &algorithm, &cpu_count, &time_quantum, &input_file);
+    parse_arguments(argc, argv, &options);
+    if (options.import_file) {
+        import_sched_dump(options.import_file, options.output_file, options.tick_ns);
+        return EXIT_SUCCESS;
+    }
+    double *cpu_speeds = parse_cpu_speeds(options.speed_list, options.cpu_count);
+    SimConfig config = { options.algorithm, options.time_quantum, options.engine };
+
+    // Batch mode: many traces, one results file, no per-trace output
+    if (options.batch_source) {
+        int trace_count = 0;
+        char **paths = list_batch_traces(options.batch_source, &trace_count);
+        run_batch(paths, trace_count, &config, options.cpu_count, cpu_speeds, options.horizon,
+                  options.thread_count, options.output_file);
+        for (int t = 0; t < trace_count; t++) free(paths[t]);
+        free(paths);
+        free(cpu_speeds);
+        return EXIT_SUCCESS;
+    }
 
     // Load processes
     Process *processes = NULL;
     int process_count = 0;
-    load_processes(input_file, &processes, &process_count);
+    load_processes(options.input_file, &processes, &process_count);
+    if (has_periodic_tasks(processes, process_count)) {
+        sim_time_t horizon = options.horizon != TIME_UNSET ? options.horizon
+                                                           : default_release_horizon(processes, process_count);
+        expand_periodic_tasks(&processes, &process_count, horizon);
+    }
+
+    // Only the human-readable format chats on stdout
+    FILE *notes = (options.format == FORMAT_TEXT) ? stdout : stderr;
 
     // Run simulation if processes were loaded successfully
-    if (process_count > 0) {
-        simulate(processes, process_count, cpu_count, algorithm, time_quantum);
+    if (process_count > 0 && options.estimate) {
+        double total_speed = 0.0;
+        for (int i = 0; i < options.cpu_count; i++) total_speed += cpu_speeds[i];
+        QueueingEstimate estimate;
+        fit_queueing_model(processes, process_count, options.cpu_count, total_speed / options.cpu_count, &estimate);
+        if (options.format == FORMAT_CSV) {
+            write_queueing_csv(&estimate);
+        } else {
+            printf("Loaded %d processes from %s\n", process_count, options.input_file);
+            print_queueing_estimates(&estimate, NULL);
+        }
+    } else if (process_count > 0 && options.replications > 0) {
+        if (options.format == FORMAT_TEXT) printf("Loaded %d processes from %s\n", process_count, options.input_file);
+        run_replications(processes, process_count, &config, options.cpu_count, cpu_speeds, options.replications,
+                         options.seed, options.ci_width, options.thread_count, options.format);
+    } else if (process_count > 0 && options.optimize) {
+        printf("Loaded %d processes from %s\n", process_count, options.input_file);
+        OptimizerConfig optimizer = { options.objective, options.switch_cost, 0, 0 };
+        parse_quantum_range(options.quantum_range, processes, process_count, options.engine,
+                            &optimizer.min_quantum, &optimizer.max_quantum);
+        optimize_quantum(processes, process_count, options.cpu_count, &config, cpu_speeds, &optimizer);
+    } else if (process_count > 0) {
+        if (options.format == FORMAT_TEXT) printf("Loaded %d processes from %s\n", process_count, options.input_file);
+        TimelineView view = { options.spill_dir, options.window_from, options.window_to, options.export_timeline };
+        simulate(processes, process_count, options.cpu_count, &config, cpu_speeds, options.format, &view);
     } else {
-        printf("No processes loaded or simulation not possible.\n");
+        fprintf(notes, "Warning: No valid processes found in %s\n", options.input_file);
+        fprintf(notes, "No processes loaded or simulation not possible.\n");
     }
 
     // Clean up
+    free(cpu_speeds);
     free(processes);
     return EXIT_SUCCESS;
 }
+#endif // SCHEDULER_NO_MAIN
@@ -17,6 +17,7 @@ The framework tests multiple scheduling algorithms:
 - Shortest Job First (SJF)
 - Shortest Remaining Time First (SRTF)
 - Round-Robin (RR) with configurable quantum
+- Gang scheduling (GANG) of process groups with configurable quantum
 
 It also tests various edge cases:
 - Priority inversion scenarios
@@ -80,9 +81,9 @@ def run_scheduler(executable: str, algorithm: str, cpus: int, quantum: int,
     
     Args:
         executable: Path to the scheduler executable
-        algorithm: Scheduling algorithm (FCFS, SJF, SRTF, RR)
+        algorithm: Scheduling algorithm (FCFS, SJF, SRTF, RR, GANG)
         cpus: Number of CPUs
-        quantum: Time quantum for Round Robin (ignored for other algorithms)
+        quantum: Time quantum for RR and GANG (ignored for other algorithms)
         input_file: Path to the process input file
         verbose: Whether to print the scheduler's output
         
@@ -93,9 +94,10 @@ def run_scheduler(executable: str, algorithm: str, cpus: int, quantum: int,
         executable,
         '-f', input_file,
         '-a', algorithm,
-        '-c', str(cpus)
+        '-c', str(cpus),
+        '--format', 'csv'  # Skip the human-readable report; only the CSV is checked
     ]
-    if algorithm == 'RR':
+    if algorithm in ('RR', 'GANG'):
         cmd.extend(['-q', str(quantum)])
 
     try:
@@ -207,6 +209,9 @@ def parse_all_csv(output: str) -> Optional[ResultsDict]:
     results['process'] = parse_csv_section(lines, 'Process Stats (CSV):')
     results['cpu'] = parse_csv_section(lines, 'CPU Stats (CSV):')
     results['average'] = parse_csv_section(lines, 'Average Stats (CSV):')
+    realtime = parse_csv_section(lines, 'Real-Time Stats (CSV):')  # Only for real-time traces
+    if realtime:
+        results['realtime'] = realtime
 
     # Check if parsing failed for any section
     if results['process'] is None or results['cpu'] is None or results['average'] is None:
@@ -336,6 +341,19 @@ def compare_results(actual: ResultsDict, expected: ResultsDict) -> List[str]:
                     mismatches.append(f"Average stats, Col '{col}': "
                                       f"Expected '{exp_avg[col]}', Got '{act_avg[col]}'")
 
+    # Compare Real-Time Stats (only when the test expects them)
+    if expected.get('realtime'):
+        if len(actual.get('realtime', [])) != 1:
+            mismatches.append("Real-time stats missing from actual output")
+        else:
+            act_rt = actual['realtime'][0]
+            for col, exp_val in expected['realtime'][0].items():
+                if col not in act_rt:
+                    mismatches.append(f"Real-time stats: Missing column '{col}' in actual output")
+                elif not compare_floats(act_rt[col], exp_val, FLOAT_TOLERANCE):
+                    mismatches.append(f"Real-time stats, Col '{col}': "
+                                      f"Expected '{exp_val}', Got '{act_rt[col]}'")
+
     return mismatches
 
 
@@ -418,6 +436,24 @@ def create_test_files() -> Dict[str, str]:
         f.write("3 2 3 4\n")      # High priority, arrives third
         f.write("4 3 1 3\n")      # Medium priority
         f.write("5 4 2 2\n")      # Low-medium priority
+
+    # Gang scheduling: two groups and an ungrouped process
+    test_files['gang'] = 'test_processes_gang.txt'
+    with open(test_files['gang'], 'w') as f:
+        f.write("# PID Arrival Burst Priority Group\n")
+        f.write("1 0 4 1 1\n")    # Group 1
+        f.write("2 0 2 1 1\n")    # Group 1, finishes before its gang-mate
+        f.write("3 1 3 1 2\n")    # Group 2 (3 members, does not fit beside group 1)
+        f.write("4 1 3 1 2\n")
+        f.write("5 1 3 1 2\n")
+        f.write("6 2 2 1\n")      # Ungrouped, a gang of one
+
+    # Periodic real-time tasks: U = 2/5 + 4/7 ~ 0.97, feasible under EDF but not RM
+    test_files['realtime'] = 'test_processes_realtime.txt'
+    with open(test_files['realtime'], 'w') as f:
+        f.write("# PID Arrival Burst Priority Group Deadline Period\n")
+        f.write("1 0 2 0 -1 0 5\n")   # Implicit deadline = period
+        f.write("2 0 4 0 -1 7 7\n")
     
     return test_files
 
@@ -729,8 +765,95 @@ def define_test_cases(test_files: Dict[str, str]) -> List[TestCase]:
         ),
     ]
 
+    gang_tests = [
+        # GANG with 4 CPUs: group 2 waits until group 1's slice ends
+        (
+            "GANG_4CPU_Q2", "GANG", 4, 2, test_files['gang'],
+            {
+                'process': [
+                    {'PID': '1', 'Arrival': '0', 'Burst': '4', 'Priority': '1', 'Start': '0', 'Finish': '6', 'Turnaround': '6', 'Waiting': '2', 'Response': '0'},
+                    {'PID': '2', 'Arrival': '0', 'Burst': '2', 'Priority': '1', 'Start': '0', 'Finish': '2', 'Turnaround': '2', 'Waiting': '0', 'Response': '0'},
+                    {'PID': '3', 'Arrival': '1', 'Burst': '3', 'Priority': '1', 'Start': '2', 'Finish': '5', 'Turnaround': '4', 'Waiting': '1', 'Response': '1'},
+                    {'PID': '4', 'Arrival': '1', 'Burst': '3', 'Priority': '1', 'Start': '2', 'Finish': '5', 'Turnaround': '4', 'Waiting': '1', 'Response': '1'},
+                    {'PID': '5', 'Arrival': '1', 'Burst': '3', 'Priority': '1', 'Start': '2', 'Finish': '5', 'Turnaround': '4', 'Waiting': '1', 'Response': '1'},
+                    {'PID': '6', 'Arrival': '2', 'Burst': '2', 'Priority': '1', 'Start': '2', 'Finish': '4', 'Turnaround': '2', 'Waiting': '0', 'Response': '0'},
+                ],
+                'cpu': [
+                    {'CPU_ID': '0', 'BusyTime': '6', 'IdleTime': '0', 'Utilization%': '100.00'},
+                    {'CPU_ID': '1', 'BusyTime': '5', 'IdleTime': '1', 'Utilization%': '83.33'},
+                    {'CPU_ID': '2', 'BusyTime': '3', 'IdleTime': '3', 'Utilization%': '50.00'},
+                    {'CPU_ID': '3', 'BusyTime': '3', 'IdleTime': '3', 'Utilization%': '50.00'}
+                ],
+                'average': [
+                    {'AvgTurnaround': '3.67', 'AvgWaiting': '0.83', 'AvgResponse': '0.50'}
+                ]
+            }
+        ),
+    ]
+
+    realtime_tests = [
+        # EDF meets every deadline at U ~ 0.97 (above the RM bound)
+        (
+            "EDF_1CPU_PERIODIC", "EDF", 1, 0, test_files['realtime'],
+            {
+                'process': [
+                    {'PID': '1', 'Arrival': '0', 'Burst': '2', 'Priority': '0', 'Start': '0', 'Finish': '2', 'Turnaround': '2', 'Waiting': '0', 'Response': '0'},
+                    {'PID': '1', 'Arrival': '5', 'Burst': '2', 'Priority': '0', 'Start': '6', 'Finish': '8', 'Turnaround': '3', 'Waiting': '1', 'Response': '1'},
+                    {'PID': '1', 'Arrival': '10', 'Burst': '2', 'Priority': '0', 'Start': '12', 'Finish': '14', 'Turnaround': '4', 'Waiting': '2', 'Response': '2'},
+                    {'PID': '1', 'Arrival': '15', 'Burst': '2', 'Priority': '0', 'Start': '15', 'Finish': '17', 'Turnaround': '2', 'Waiting': '0', 'Response': '0'},
+                    {'PID': '1', 'Arrival': '20', 'Burst': '2', 'Priority': '0', 'Start': '20', 'Finish': '22', 'Turnaround': '2', 'Waiting': '0', 'Response': '0'},
+                    {'PID': '1', 'Arrival': '25', 'Burst': '2', 'Priority': '0', 'Start': '26', 'Finish': '28', 'Turnaround': '3', 'Waiting': '1', 'Response': '1'},
+                    {'PID': '1', 'Arrival': '30', 'Burst': '2', 'Priority': '0', 'Start': '32', 'Finish': '34', 'Turnaround': '4', 'Waiting': '2', 'Response': '2'},
+                    {'PID': '2', 'Arrival': '0', 'Burst': '4', 'Priority': '0', 'Start': '2', 'Finish': '6', 'Turnaround': '6', 'Waiting': '2', 'Response': '2'},
+                    {'PID': '2', 'Arrival': '7', 'Burst': '4', 'Priority': '0', 'Start': '8', 'Finish': '12', 'Turnaround': '5', 'Waiting': '1', 'Response': '1'},
+                    {'PID': '2', 'Arrival': '14', 'Burst': '4', 'Priority': '0', 'Start': '14', 'Finish': '20', 'Turnaround': '6', 'Waiting': '2', 'Response': '0'},
+                    {'PID': '2', 'Arrival': '21', 'Burst': '4', 'Priority': '0', 'Start': '22', 'Finish': '26', 'Turnaround': '5', 'Waiting': '1', 'Response': '1'},
+                    {'PID': '2', 'Arrival': '28', 'Burst': '4', 'Priority': '0', 'Start': '28', 'Finish': '32', 'Turnaround': '4', 'Waiting': '0', 'Response': '0'}
+                ],
+                'cpu': [
+                    {'CPU_ID': '0', 'BusyTime': '34', 'IdleTime': '0', 'Utilization%': '100.00'}
+                ],
+                'average': [
+                    {'AvgTurnaround': '3.83', 'AvgWaiting': '1.00', 'AvgResponse': '0.83'}
+                ],
+                'realtime': [
+                    {'Tasks': '2', 'Jobs': '12', 'Misses': '0', 'MaxLateness': '0', 'EDFGuaranteed': '1', 'RMGuaranteed': '0'}
+                ]
+            }
+        ),
+        # RM: task 1's shorter period starves task 2's first job past its deadline at 7
+        (
+            "RM_1CPU_PERIODIC", "RM", 1, 0, test_files['realtime'],
+            {
+                'process': [
+                    {'PID': '1', 'Arrival': '0', 'Burst': '2', 'Priority': '0', 'Start': '0', 'Finish': '2', 'Turnaround': '2', 'Waiting': '0', 'Response': '0'},
+                    {'PID': '1', 'Arrival': '5', 'Burst': '2', 'Priority': '0', 'Start': '5', 'Finish': '7', 'Turnaround': '2', 'Waiting': '0', 'Response': '0'},
+                    {'PID': '1', 'Arrival': '10', 'Burst': '2', 'Priority': '0', 'Start': '10', 'Finish': '12', 'Turnaround': '2', 'Waiting': '0', 'Response': '0'},
+                    {'PID': '1', 'Arrival': '15', 'Burst': '2', 'Priority': '0', 'Start': '15', 'Finish': '17', 'Turnaround': '2', 'Waiting': '0', 'Response': '0'},
+                    {'PID': '1', 'Arrival': '20', 'Burst': '2', 'Priority': '0', 'Start': '20', 'Finish': '22', 'Turnaround': '2', 'Waiting': '0', 'Response': '0'},
+                    {'PID': '1', 'Arrival': '25', 'Burst': '2', 'Priority': '0', 'Start': '25', 'Finish': '27', 'Turnaround': '2', 'Waiting': '0', 'Response': '0'},
+                    {'PID': '1', 'Arrival': '30', 'Burst': '2', 'Priority': '0', 'Start': '30', 'Finish': '32', 'Turnaround': '2', 'Waiting': '0', 'Response': '0'},
+                    {'PID': '2', 'Arrival': '0', 'Burst': '4', 'Priority': '0', 'Start': '2', 'Finish': '8', 'Turnaround': '8', 'Waiting': '4', 'Response': '2'},
+                    {'PID': '2', 'Arrival': '7', 'Burst': '4', 'Priority': '0', 'Start': '8', 'Finish': '14', 'Turnaround': '7', 'Waiting': '3', 'Response': '1'},
+                    {'PID': '2', 'Arrival': '14', 'Burst': '4', 'Priority': '0', 'Start': '14', 'Finish': '20', 'Turnaround': '6', 'Waiting': '2', 'Response': '0'},
+                    {'PID': '2', 'Arrival': '21', 'Burst': '4', 'Priority': '0', 'Start': '22', 'Finish': '28', 'Turnaround': '7', 'Waiting': '3', 'Response': '1'},
+                    {'PID': '2', 'Arrival': '28', 'Burst': '4', 'Priority': '0', 'Start': '28', 'Finish': '34', 'Turnaround': '6', 'Waiting': '2', 'Response': '0'}
+                ],
+                'cpu': [
+                    {'CPU_ID': '0', 'BusyTime': '34', 'IdleTime': '0', 'Utilization%': '100.00'}
+                ],
+                'average': [
+                    {'AvgTurnaround': '4.00', 'AvgWaiting': '1.17', 'AvgResponse': '0.33'}
+                ],
+                'realtime': [
+                    {'Tasks': '2', 'Jobs': '12', 'Misses': '1', 'MaxLateness': '1', 'EDFGuaranteed': '1', 'RMGuaranteed': '0'}
+                ]
+            }
+        ),
+    ]
+
     # Combine all tests
-    return fcfs_tests + sjf_tests + srtf_tests + rr_tests
+    return fcfs_tests + sjf_tests + srtf_tests + rr_tests + gang_tests + realtime_tests
 
 
 def run_tests(executable_path: str, tests: List[TestCase], verbose: bool = False) -> Tuple[int, int]:
@@ -752,7 +875,7 @@ def run_tests(executable_path: str, tests: List[TestCase], verbose: bool = False
 
     for name, algo, cpus, quantum, infile, expected in tests:
         print(f"\n{COLOR_YELLOW}--- Test: {name} ({algo}, {cpus} CPU(s), "
-              f"Q={quantum if algo=='RR' else 'N/A'}) ---{COLOR_RESET}")
+              f"Q={quantum if algo in ('RR', 'GANG') else 'N/A'}) ---{COLOR_RESET}")
 
         # Run scheduler
         output = run_scheduler(executable_path, algo, cpus, quantum, infile, verbose)
@@ -781,12 +904,318 @@ def run_tests(executable_path: str, tests: List[TestCase], verbose: bool = False
     return passed_tests, total_tests
 
 
+def report_check(mismatches: List[str]) -> bool:
+    """
+    Print the verdict of a whole-program check.
+
+    Args:
+        mismatches: Problems the check found
+
+    Returns:
+        True if the check passed
+    """
+    if not mismatches:
+        print(f"{COLOR_GREEN}{COLOR_BOLD}>>> TEST PASSED{COLOR_RESET}")
+        return True
+    print(f"{COLOR_RED}{COLOR_BOLD}>>> TEST FAILED{COLOR_RESET}")
+    for mismatch in mismatches:
+        print(f"  - {mismatch}")
+    return False
+
+
+def run_batch_check(executable: str, test_files: Dict[str, str]) -> List[str]:
+    """
+    Check that batch mode (-b) reports the same averages as single-trace runs.
+
+    Args:
+        executable: Path to the scheduler executable
+        test_files: Mapping of test file keys to paths
+
+    Returns:
+        Mismatches between batch rows and the corresponding single runs
+    """
+    print(f"\n{COLOR_YELLOW}--- Test: BATCH_CONSISTENCY (FCFS/SJF/SRTF, 2 CPU(s)) ---{COLOR_RESET}")
+    paths = sorted(path for key, path in test_files.items() if key != 'gang')
+    manifest = 'test_batch_manifest.txt'
+    mismatches = []
+    try:
+        with open(manifest, 'w') as f:
+            f.write("# Generated by test_scheduler.py\n")
+            f.write("\n".join(os.path.abspath(path) for path in paths) + "\n")
+
+        for algo in ('FCFS', 'SJF', 'SRTF'):
+            cmd = [executable, '-b', manifest, '-a', algo, '-c', '2', '-j', '2']
+            print(f"Running: {' '.join(cmd)}")
+            result = subprocess.run(cmd, capture_output=True, text=True, check=True, timeout=DEFAULT_TIMEOUT)
+            rows = list(csv.DictReader(io.StringIO(result.stdout)))
+            if len(rows) != len(paths):
+                mismatches.append(f"{algo}: expected {len(paths)} rows, got {len(rows)}")
+                continue
+
+            for path, row in zip(paths, rows):
+                output = run_scheduler(executable, algo, 2, 1, path)
+                single = parse_all_csv(output) if output else None
+                if not single or not single['average']:
+                    mismatches.append(f"{algo} {path}: single run failed")
+                    continue
+                expected = single['average'][0]
+                for col in ('AvgTurnaround', 'AvgWaiting', 'AvgResponse'):
+                    if not compare_floats(row[col], expected[col], FLOAT_TOLERANCE):
+                        mismatches.append(f"{algo} {path}: {col} batch {row[col]} vs single {expected[col]}")
+    except (subprocess.CalledProcessError, subprocess.TimeoutExpired, OSError) as e:
+        mismatches.append(f"batch run failed: {e}")
+    finally:
+        if os.path.exists(manifest):
+            os.remove(manifest)
+
+    return mismatches
+
+
+def run_optimizer_check(executable: str, test_files: Dict[str, str]) -> List[str]:
+    """
+    Check that the quantum optimizer's best trial matches a plain run at that quantum.
+
+    Args:
+        executable: Path to the scheduler executable
+        test_files: Mapping of test file keys to paths
+
+    Returns:
+        Mismatches between the reported best trial and a normal RR run
+    """
+    print(f"\n{COLOR_YELLOW}--- Test: RR_QUANTUM_OPTIMIZER (RR, 2 CPU(s)) ---{COLOR_RESET}")
+    path = test_files['scenario_two']
+    cmd = [executable, '-f', path, '-a', 'RR', '-c', '2', '--optimize', 'response', '--switch-cost', '0.05']
+    mismatches = []
+    try:
+        print(f"Running: {' '.join(cmd)}")
+        result = subprocess.run(cmd, capture_output=True, text=True, check=True, timeout=DEFAULT_TIMEOUT)
+        trials = parse_csv_section(result.stdout.splitlines(), 'Quantum Search (CSV):')
+        best = [row for row in (trials or []) if row['Best'] == '1']
+        if len(best) != 1:
+            mismatches.append("expected exactly one best trial")
+        else:
+            best = best[0]
+            if any(float(row['Objective']) < float(best['Objective']) for row in trials):
+                mismatches.append("a trial beats the reported best quantum")
+            single = parse_all_csv(run_scheduler(executable, 'RR', 2, best['Quantum'], path))
+            expected = single['average'][0] if single and single['average'] else None
+            if expected is None:
+                mismatches.append(f"plain run at quantum {best['Quantum']} failed")
+            else:
+                for col in ('AvgTurnaround', 'AvgWaiting', 'AvgResponse'):
+                    if not compare_floats(best[col], expected[col], FLOAT_TOLERANCE):
+                        mismatches.append(f"{col}: optimizer {best[col]} vs plain run {expected[col]}")
+    except (subprocess.CalledProcessError, subprocess.TimeoutExpired, KeyError, ValueError) as e:
+        mismatches.append(f"optimizer run failed: {e}")
+
+    return mismatches
+
+
+def run_replication_check(executable: str, test_files: Dict[str, str]) -> List[str]:
+    """
+    Check that Monte-Carlo replication is reproducible and stops early on a wide target.
+
+    Args:
+        executable: Path to the scheduler executable
+        test_files: Mapping of test file keys to paths
+
+    Returns:
+        Problems with reproducibility across thread counts or early stopping
+    """
+    print(f"\n{COLOR_YELLOW}--- Test: MONTE_CARLO_REPLICATION (RR, 2 CPU(s)) ---{COLOR_RESET}")
+    base = [executable, '-f', test_files['scenario_two'], '-a', 'RR', '-c', '2', '--seed', '3', '--format', 'csv']
+    mismatches = []
+    try:
+        runs = {}
+        for args in (['--replicate', '40', '-j', '1'], ['--replicate', '40', '-j', '3'],
+                     ['--replicate', '40', '--ci-width', '1000']):
+            cmd = base + args
+            print(f"Running: {' '.join(cmd)}")
+            result = subprocess.run(cmd, capture_output=True, text=True, check=True, timeout=DEFAULT_TIMEOUT)
+            runs[' '.join(args)] = parse_csv_section(result.stdout.splitlines(), 'Replication Stats (CSV):')
+        serial, parallel, early = runs.values()
+        if serial != parallel:
+            mismatches.append("estimates differ between 1 and 3 worker threads")
+        for row in serial or []:
+            if not float(row['CILow']) <= float(row['Mean']) <= float(row['CIHigh']):
+                mismatches.append(f"{row['Metric']}: mean outside its confidence interval")
+            if row['Replications'] != '40':
+                mismatches.append(f"{row['Metric']}: expected 40 replications, got {row['Replications']}")
+        if not early or any(row['Replications'] != '8' for row in early):
+            mismatches.append("a 1000-tick CI target should stop after the first round of 8")
+        if not serial:
+            mismatches.append("no replication stats in output")
+    except (subprocess.CalledProcessError, subprocess.TimeoutExpired, KeyError, ValueError) as e:
+        mismatches.append(f"replication run failed: {e}")
+
+    return mismatches
+
+
+def run_estimator_check(executable: str) -> List[str]:
+    """
+    Check the queueing-model estimator on a deterministic D/D/1 trace.
+
+    Jobs of 1 tick arrive every 2 ticks (rho = 0.5, no variability), so
+    M/M/1 predicts a wait of rho/(mu - lambda) = 1, M/G/1 lambda*E[S^2]/(2(1-rho))
+    = 0.5, and Kingman 0, which is what the simulator observes.
+
+    Args:
+        executable: Path to the scheduler executable
+
+    Returns:
+        Models whose estimates differ from their closed forms
+    """
+    print(f"\n{COLOR_YELLOW}--- Test: QUEUEING_ESTIMATOR (D/D/1) ---{COLOR_RESET}")
+    path = 'test_processes_deterministic.txt'
+    with open(path, 'w') as f:
+        for pid in range(1, 11):
+            f.write(f"{pid} {2 * (pid - 1)} 1\n")
+    expected = {'M/M/c': 1.0, 'M/G/1': 0.5, 'Kingman': 0.0}
+    mismatches = []
+    try:
+        cmd = [executable, '-f', path, '--estimate', '--format', 'csv']
+        print(f"Running: {' '.join(cmd)}")
+        result = subprocess.run(cmd, capture_output=True, text=True, check=True, timeout=DEFAULT_TIMEOUT)
+        section = parse_csv_section(result.stdout.splitlines(), 'Model Estimates (CSV):') or []
+        rows = {row['Model']: row for row in section}
+        for model, wait in expected.items():
+            if model not in rows:
+                mismatches.append(f"{model}: missing from output")
+                continue
+            if not compare_floats(rows[model]['Utilization'], '0.5', FLOAT_TOLERANCE):
+                mismatches.append(f"{model}: utilization {rows[model]['Utilization']}, expected 0.5")
+            if not compare_floats(rows[model]['AvgWaiting'], str(wait), FLOAT_TOLERANCE):
+                mismatches.append(f"{model}: waiting {rows[model]['AvgWaiting']}, expected {wait}")
+    except (subprocess.CalledProcessError, subprocess.TimeoutExpired, KeyError, ValueError) as e:
+        mismatches.append(f"estimator run failed: {e}")
+    finally:
+        os.remove(path)
+
+    return mismatches
+
+
+def run_timeline_check(executable: str, test_files: Dict[str, str]) -> List[str]:
+    """
+    Check that a spilled timeline matches the in-memory one and that windows page correctly.
+
+    Args:
+        executable: Path to the scheduler executable
+        test_files: Mapping of test file keys to paths
+
+    Returns:
+        Differences from the in-memory run and the clipped full export
+    """
+    print(f"\n{COLOR_YELLOW}--- Test: TIMELINE_SPILL (RR, 2 CPU(s)) ---{COLOR_RESET}")
+    base = [executable, '-f', test_files['scenario_two'], '-a', 'RR', '-c', '2', '-q', '1']
+    exports = {'full': 'test_timeline_full.csv', 'window': 'test_timeline_window.csv'}
+    mismatches = []
+    try:
+        outputs = []
+        for args in ([], ['--spill', '.', '--export-timeline', exports['full']],
+                     ['--spill', '.', '--window', '3.5,9', '--export-timeline', exports['window'],
+                      '--format', 'csv']):
+            cmd = base + args
+            print(f"Running: {' '.join(cmd)}")
+            result = subprocess.run(cmd, capture_output=True, text=True, check=True, timeout=DEFAULT_TIMEOUT)
+            outputs.append(result.stdout)
+        if outputs[0] != outputs[1]:
+            mismatches.append("spilled timeline output differs from the in-memory one")
+
+        with open(exports['full']) as f:
+            full = list(csv.DictReader(f))
+        with open(exports['window']) as f:
+            window = [(row['CPU'], row['PID'], float(row['Start']), float(row['End'])) for row in csv.DictReader(f)]
+        expected = [(row['CPU'], row['PID'], max(float(row['Start']), 3.5), min(float(row['End']), 9.0))
+                    for row in full if float(row['End']) > 3.5 and float(row['Start']) < 9.0]
+        if sorted(window) != sorted(expected):
+            mismatches.append(f"window 3.5,9 exported {len(window)} segment(s), expected {len(expected)}")
+        if not full:
+            mismatches.append("no segments exported")
+    except (subprocess.CalledProcessError, subprocess.TimeoutExpired, KeyError, ValueError, OSError) as e:
+        mismatches.append(f"timeline run failed: {e}")
+    finally:
+        for path in exports.values():
+            if os.path.exists(path):
+                os.remove(path)
+
+    return mismatches
+
+
+def run_import_check(executable: str) -> List[str]:
+    """
+    Check the perf sched / ftrace importer on the same events in both text layouts.
+
+    bash (pid 10) runs 0-3 ticks, is preempted by a woken kworker (pid 20,
+    1.5 ticks), then runs 1.5 more and blocks: one 4.5-tick burst arriving at
+    0 and one 1.5-tick burst arriving at 2. Its next burst gets no CPU time
+    before the dump ends and is dropped.
+
+    Args:
+        executable: Path to the scheduler executable
+
+    Returns:
+        Dumps that do not import to the expected trace
+    """
+    print(f"\n{COLOR_YELLOW}--- Test: TRACE_IMPORT (ftrace, perf sched) ---{COLOR_RESET}")
+    events = [  # (time, cpu, task, event, key=value fields, compact fields)
+        ('100.000000', 0, ('swapper', 0), 'sched_switch',
+         'prev_comm=swapper/0 prev_pid=0 prev_prio=120 prev_state=R ==> next_comm=bash next_pid=10 next_prio=120',
+         'swapper/0:0 [120] R ==> bash:10 [120]'),
+        ('100.002000', 0, ('bash', 10), 'sched_wakeup',
+         'comm=kworker/0:1 pid=20 prio=100 target_cpu=000', 'kworker/0:1:20 [100] CPU:000'),
+        ('100.003000', 0, ('bash', 10), 'sched_switch',
+         'prev_comm=bash prev_pid=10 prev_prio=120 prev_state=R+ ==> next_comm=kworker/0:1 next_pid=20 next_prio=100',
+         'bash:10 [120] R ==> kworker/0:1:20 [100]'),
+        ('100.004500', 0, ('kworker/0:1', 20), 'sched_switch',
+         'prev_comm=kworker/0:1 prev_pid=20 prev_prio=100 prev_state=I ==> next_comm=bash next_pid=10 next_prio=120',
+         'kworker/0:1:20 [100] I ==> bash:10 [120]'),
+        ('100.006000', 0, ('bash', 10), 'sched_switch',
+         'prev_comm=bash prev_pid=10 prev_prio=120 prev_state=S ==> next_comm=swapper/0 next_pid=0 next_prio=120',
+         'bash:10 [120] S ==> swapper/0:0 [120]'),
+        ('100.007000', 1, ('swapper', 0), 'sched_wakeup',
+         'comm=bash pid=10 prio=120 target_cpu=001', 'bash:10 [120] success=1 CPU:001'),
+        ('100.007500', 1, ('swapper', 0), 'sched_switch',
+         'prev_comm=swapper/1 prev_pid=0 prev_prio=120 prev_state=R ==> next_comm=bash next_pid=10 next_prio=120',
+         'swapper/1:0 [120] R ==> bash:10 [120]'),
+    ]
+    dumps = {
+        'test_import_ftrace.txt': ['# tracer: nop', '#'] + [
+            f"{comm:>16}-{pid:<6} [{cpu:03d}] d..2.  {time}: {event}: {fields}"
+            for time, cpu, (comm, pid), event, fields, _ in events],
+        'test_import_perf.txt': [
+            f"{comm:>16} {pid:5d} [{cpu:03d}]   {time}:       sched:{event}: {compact}"
+            for time, cpu, (comm, pid), event, _, compact in events],
+    }
+    expected = ['1 2 1.5 39', '2 0 4.5 19']
+    trace_path = 'test_import_trace.txt'
+    mismatches = []
+    try:
+        for dump, lines in dumps.items():
+            with open(dump, 'w') as f:
+                f.write('\n'.join(lines) + '\n')
+            cmd = [executable, '--import', dump, '-o', trace_path]
+            print(f"Running: {' '.join(cmd)}")
+            subprocess.run(cmd, capture_output=True, text=True, check=True, timeout=DEFAULT_TIMEOUT)
+            with open(trace_path) as f:
+                trace = [line.strip() for line in f if not line.startswith('#')]
+            if trace != expected:
+                mismatches.append(f"{dump}: imported {trace}, expected {expected}")
+    except (subprocess.CalledProcessError, subprocess.TimeoutExpired, OSError) as e:
+        mismatches.append(f"import run failed: {e}")
+    finally:
+        for path in list(dumps) + [trace_path]:
+            if os.path.exists(path):
+                os.remove(path)
+
+    return mismatches
+
+
 def main() -> None:
     """Main function to parse arguments and execute tests."""
     parser = argparse.ArgumentParser(description="Test harness for the CPU scheduler implementation.")
     parser.add_argument('--executable', default=SCHEDULER_EXECUTABLE,
                         help=f"Path to the scheduler executable (default: {SCHEDULER_EXECUTABLE})")
-    parser.add_argument('--algorithm', choices=['FCFS', 'SJF', 'SRTF', 'RR'], 
+    parser.add_argument('--algorithm', choices=['FCFS', 'SJF', 'SRTF', 'RR', 'GANG', 'EDF', 'RM'], 
                         help="Run only tests for specified algorithm")
     parser.add_argument('--test', help="Run only the specified test by name")
     parser.add_argument('--verbose', action='store_true', help="Show detailed scheduler output")
@@ -822,6 +1251,21 @@ def main() -> None:
     
     # Run the filtered tests
     passed, total = run_tests(executable_path, tests_to_run, args.verbose)
+
+    # Batch mode, the optimizer, replication, the estimator, timeline paging and trace import are checked as a whole (skipped when filtering tests)
+    if not args.algorithm and not args.test:
+        checks = [
+            lambda: run_batch_check(executable_path, test_files),
+            lambda: run_optimizer_check(executable_path, test_files),
+            lambda: run_replication_check(executable_path, test_files),
+            lambda: run_estimator_check(executable_path),
+            lambda: run_timeline_check(executable_path, test_files),
+            lambda: run_import_check(executable_path),
+        ]
+        for check in checks:
+            total += 1
+            if report_check(check()):
+                passed += 1
     
     # Print summary
     print(f"\n{COLOR_CYAN}--- Test Summary ---{COLOR_RESET}")
@@ -12,14 +12,79 @@ pub struct Cli {
     #[arg(default_value_t=PageReplacementAlgorithm::Fifo)]
     pub pra: PageReplacementAlgorithm,
 
+    /// Entries in the L1 TLB (in each half when split)
     #[arg(short, long, default_value_t = 16)]
     pub tlb_entries: usize,
 
-    #[arg(short, long, default_value_t = 256)]
+    /// Associativity of the L1 TLB (0 for fully associative)
+    #[arg(long, default_value_t = 0)]
+    pub tlb_ways: usize,
+
+    /// Replacement policy of the L1 TLB
+    #[arg(long, value_enum, default_value = "fifo")]
+    pub tlb_policy: TlbPolicy,
+
+    /// Split the L1 TLB into instruction and data halves (trace lines "I <address>" are fetches)
+    #[arg(long)]
+    pub split_tlb: bool,
+
+    /// Entries in the unified L2 TLB (0 for none)
+    #[arg(long, default_value_t = 0)]
+    pub l2_tlb_entries: usize,
+
+    /// Associativity of the L2 TLB (0 for fully associative)
+    #[arg(long, default_value_t = 0)]
+    pub l2_tlb_ways: usize,
+
+    /// Replacement policy of the L2 TLB
+    #[arg(long, value_enum, default_value = "lru")]
+    pub l2_tlb_policy: TlbPolicy,
+
+    /// Cycles per L1 TLB lookup
+    #[arg(long, default_value_t = 1)]
+    pub l1_latency: usize,
+
+    /// Cycles per L2 TLB lookup
+    #[arg(long, default_value_t = 7)]
+    pub l2_latency: usize,
+
+    /// Cycles per memory reference of a page walk
+    #[arg(long, default_value_t = 100)]
+    pub memory_latency: usize,
+
+    /// Page size in bytes, a power of two
+    #[arg(short, long, default_value_t = 256, value_parser = parse_page_size)]
     pub page_size: usize,
 
+    /// Width of a virtual address in bits
+    #[arg(short, long, default_value_t = 16, value_parser = clap::value_parser!(u32).range(1..=64))]
+    pub address_bits: u32,
+
+    /// Page table organization
+    #[arg(long, value_enum, default_value = "flat")]
+    pub page_table: PageTableKind,
+
+    /// Entries in the page-walk cache of a radix page table (0 for none)
+    #[arg(long, default_value_t = 0)]
+    pub walk_cache: usize,
+
     #[arg(short, long)]
     pub debug: bool,
+
+    /// Print only the fault and TLB statistics
+    #[arg(short, long)]
+    pub quiet: bool,
+
+    /// Instead of simulating, print the LRU and OPT miss-ratio curves for every frame count as CSV
+    #[arg(long)]
+    pub mrc: bool,
+}
+
+fn parse_page_size(arg: &str) -> Result<usize, String> {
+    match arg.parse::<usize>() {
+        Ok(size) if size.is_power_of_two() => Ok(size),
+        _ => Err(format!("{} is not a power of two", arg)),
+    }
 }
 
 #[derive(Debug, Clone)]
@@ -27,6 +92,11 @@ pub enum PageReplacementAlgorithm {
     Fifo,
     Lru,
     Opt,
+    Clock,
+    SecondChance,
+    Lfu,
+    Arc,
+    TwoQ,
 }
 
 // Below is boilerplate to allow for strict all caps CLI matching
@@ -36,6 +106,11 @@ impl fmt::Display for PageReplacementAlgorithm {
             PageReplacementAlgorithm::Fifo => "FIFO",
             PageReplacementAlgorithm::Lru => "LRU",
             PageReplacementAlgorithm::Opt => "OPT",
+            PageReplacementAlgorithm::Clock => "CLOCK",
+            PageReplacementAlgorithm::SecondChance => "SECOND_CHANCE",
+            PageReplacementAlgorithm::Lfu => "LFU",
+            PageReplacementAlgorithm::Arc => "ARC",
+            PageReplacementAlgorithm::TwoQ => "2Q",
         };
         write!(f, "{}", s)
     }
@@ -43,10 +118,15 @@ impl fmt::Display for PageReplacementAlgorithm {
 
 impl ValueEnum for PageReplacementAlgorithm {
     fn value_variants<'a>() -> &'a [Self] {
-        static VARIANTS: [PageReplacementAlgorithm; 3] = [
+        static VARIANTS: [PageReplacementAlgorithm; 8] = [
             PageReplacementAlgorithm::Fifo,
             PageReplacementAlgorithm::Lru,
             PageReplacementAlgorithm::Opt,
+            PageReplacementAlgorithm::Clock,
+            PageReplacementAlgorithm::SecondChance,
+            PageReplacementAlgorithm::Lfu,
+            PageReplacementAlgorithm::Arc,
+            PageReplacementAlgorithm::TwoQ,
         ];
         &VARIANTS
     }
@@ -56,6 +136,39 @@ impl ValueEnum for PageReplacementAlgorithm {
             PageReplacementAlgorithm::Fifo => PossibleValue::new("FIFO"),
             PageReplacementAlgorithm::Lru => PossibleValue::new("LRU"),
             PageReplacementAlgorithm::Opt => PossibleValue::new("OPT"),
+            PageReplacementAlgorithm::Clock => PossibleValue::new("CLOCK"),
+            PageReplacementAlgorithm::SecondChance => PossibleValue::new("SECOND_CHANCE"),
+            PageReplacementAlgorithm::Lfu => PossibleValue::new("LFU"),
+            PageReplacementAlgorithm::Arc => PossibleValue::new("ARC"),
+            PageReplacementAlgorithm::TwoQ => PossibleValue::new("2Q"),
         })
     }
 }
+
+#[derive(Debug, Clone, PartialEq, ValueEnum)]
+pub enum PageTableKind {
+    Flat,
+    Radix2,
+    Radix3,
+    Radix4,
+    Hashed,
+    Inverted,
+}
+
+#[derive(Debug, Clone, PartialEq, ValueEnum)]
+pub enum TlbPolicy {
+    Fifo,
+    Lru,
+    Plru,
+    Random,
+}
+
+impl Cli {
+    /// Whether the TLB differs from the default single fully associative FIFO
+    pub fn tlb_configured(&self) -> bool {
+        self.tlb_ways != 0
+            || self.tlb_policy != TlbPolicy::Fifo
+            || self.split_tlb
+            || self.l2_tlb_entries != 0
+    }
+}
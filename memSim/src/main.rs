@@ -1,176 +1,114 @@
-use clap::Parser;
+use clap::{error::ErrorKind, CommandFactory, Parser};
 use std::{
     fs,
-    io::{Read, Seek, SeekFrom},
+    io::{self, BufWriter, Write},
+    path::Path,
 };
 mod cli;
-use cli::{Cli, PageReplacementAlgorithm};
+use cli::{Cli, PageTableKind};
+mod memory;
+use memory::{BackingStore, PhysicalMemory};
+mod page_table;
+use page_table::{AddressFormat, PageTable};
+mod replacement;
+mod stack_distance;
 mod tlb;
-use tlb::Tlb;
+use tlb::TlbHierarchy;
 
 struct PageTableEntry {
     insertion_time: usize,
     pn: usize,
+    referenced: bool, // Set on every reference, cleared by CLOCK and second chance
+    dirty: bool,      // Written since it was loaded
 }
 
-impl PageReplacementAlgorithm {
-    fn algorithm(
-        &self,
-        ram_frames: &mut [PageTableEntry],
-        all_pns: &[usize],
-        present_idx: usize,
-    ) -> (usize, usize) {
-        match self {
-            PageReplacementAlgorithm::Fifo => fifo(ram_frames, all_pns, present_idx),
-            PageReplacementAlgorithm::Lru => lru(ram_frames, all_pns, present_idx),
-            PageReplacementAlgorithm::Opt => opt(ram_frames, all_pns, present_idx),
-        }
-    }
-}
-
-fn opt(
-    ram_frames: &mut [PageTableEntry],
-    all_pns: &[usize],
-    present_idx: usize,
-) -> (usize, usize) {
-    let mut longest_dist: usize = 0;
-    let mut longest_pn_idx: usize = 0;
-
-    // If we're at the final page number
-    if present_idx == all_pns.len() - 1 {
-        // It doesn't matter who we eject
-        return (0, eject(ram_frames, all_pns, present_idx, 0));
-    }
-
-    // For each page number in the page table
-    for (idx, entry) in ram_frames.iter().enumerate() {
-        let mut found: bool = false;
-
-        // Find the soonest occurrence of this page number in the future
-        for (future_idx, pn) in all_pns.iter().enumerate().skip(present_idx + 1) {
-            if entry.pn == *pn {
-                let dist = future_idx - present_idx;
-                found = true;
-
-                // If this is farther than the last page number we found, save it to kick out
-                if dist > longest_dist {
-                    longest_dist = dist;
-                    longest_pn_idx = idx;
-                }
-                break;
-            }
-        }
-
-        // If we didn't find any future occurrences of this page number
-        if !found {
-            // We should kick it out, it will never be used again
-            longest_pn_idx = idx;
-            break;
-        }
-    }
-
-    (
-        longest_pn_idx,
-        eject(ram_frames, all_pns, present_idx, longest_pn_idx),
-    )
-}
-
-fn lru(
-    ram_frames: &mut [PageTableEntry],
-    all_pns: &[usize],
-    present_idx: usize,
-) -> (usize, usize) {
-    let mut longest_dist: usize = 0;
-    let mut longest_pn_idx: usize = 0;
-
-    // If we're at the final page number
-    if present_idx == all_pns.len() - 1 {
-        // It doesn't matter who we eject
-        return (0, eject(ram_frames, all_pns, present_idx, 0));
-    }
-
-    // For each page number in the page table
-    for (idx, entry) in ram_frames.iter().enumerate() {
-        // Find the closest occurrence of this page number in the past
-        for (past_idx, pn) in all_pns.iter().enumerate().take(present_idx - 1) {
-            if entry.pn == *pn {
-                let dist = present_idx - past_idx;
-
-                // If this is farther than the last page number we found, save it to kick out
-                if dist > longest_dist {
-                    longest_dist = dist;
-                    longest_pn_idx = idx;
-                }
-                break;
-            }
-        }
-    }
-
-    (
-        longest_pn_idx,
-        eject(ram_frames, all_pns, present_idx, longest_pn_idx),
-    )
-}
-
-fn fifo(
-    ram_frames: &mut [PageTableEntry],
-    all_pns: &[usize],
-    present_idx: usize,
-) -> (usize, usize) {
-    let mut oldest_time = usize::MAX;
-    let mut oldest_idx: usize = 0;
-
-    // For each page number in the page table
-    for (idx, entry) in ram_frames.iter().enumerate() {
-        // Find if this is the oldest page number inserted into the page table
-        if entry.insertion_time < oldest_time {
-            oldest_time = entry.insertion_time;
-            oldest_idx = idx;
-        }
-    }
-
-    (
-        oldest_idx,
-        eject(ram_frames, all_pns, present_idx, oldest_idx),
-    )
+#[derive(Clone, Copy, PartialEq)]
+enum Access {
+    Read,
+    Write,
+    Fetch,
 }
 
 fn main() {
     /**********STRUCTURE DECLARATION**********/
     let args = Cli::parse();
+    if args.page_size.trailing_zeros() > args.address_bits {
+        Cli::command()
+            .error(
+                ErrorKind::ArgumentConflict,
+                "the page size does not fit in the address width",
+            )
+            .exit();
+    }
+    let format = AddressFormat::new(args.address_bits, args.page_size);
 
-    let mut tlb = Tlb::new(args.tlb_entries);
+    let mut tlb = TlbHierarchy::new(&args).unwrap_or_else(|message| {
+        Cli::command()
+            .error(ErrorKind::ArgumentConflict, message)
+            .exit()
+    });
     let mut ram_frames: Vec<PageTableEntry> = Vec::with_capacity(args.frames);
+    let mut page_table = PageTable::new(&args.page_table, &format, args.frames, args.walk_cache)
+        .unwrap_or_else(|message| {
+            Cli::command()
+                .error(ErrorKind::ArgumentConflict, message)
+                .exit()
+        });
 
     let mut tlb_misses = 0;
     let mut page_faults = 0;
+    let mut write_backs = 0;
 
-    let mut backing_store =
-        fs::File::open("BACKING_STORE.bin").expect("Unable to read BACKING_STORE.bin!");
+    let backing_store = BackingStore::open(Path::new("BACKING_STORE.bin"), args.page_size)
+        .expect("Unable to read BACKING_STORE.bin!");
+    let mut memory = PhysicalMemory::new(args.page_size);
 
     /**********FILE PARSING**********/
     // Get all the the page numbers fromt the file
     let contents = fs::read_to_string(&args.file)
         .unwrap_or_else(|_| panic!("Unable to read file: {}", args.file.display()));
 
-    // Structured as logical address, page number, offset
-    let page_numbers_zipped: Vec<(usize, usize, usize)> = contents
+    // Structured as logical address, page number, offset, access type
+    let page_numbers_zipped: Vec<(usize, usize, usize, Access)> = contents
         .split('\n')
-        .filter_map(|string| string.parse().ok())
-        .map(|address| (address, (address >> 8usize) & 0xFF, address & 0xFF))
+        .filter_map(parse_access)
+        .map(|(address, access)| {
+            let (pn, offset) = format.split(address);
+            (address, pn, offset, access)
+        })
         .collect();
 
-    let page_numbers: Vec<usize> = page_numbers_zipped.iter().map(|(_, pn, _)| *pn).collect();
+    let page_numbers: Vec<usize> = page_numbers_zipped
+        .iter()
+        .map(|(_, pn, _, _)| *pn)
+        .collect();
+
+    let mut out = BufWriter::new(io::stdout().lock());
+    if args.mrc {
+        stack_distance::write_mrc(&mut out, &page_numbers)
+            .and_then(|()| out.flush())
+            .expect("Unable to write output!");
+        return;
+    }
 
     /**********RUNNING SIMULATOR**********/
+    let mut line: Vec<u8> = Vec::new(); // Reused for every output line
+    let mut replacer = args.pra.replacer(&page_numbers, args.frames);
+
     // Check the TLB, if in TLB move on, else look at Page Table
     for (i, page_number) in page_numbers.iter().enumerate() {
         let mut page_frame_idx = usize::MAX;
+        let mut frame = usize::MAX;
+
+        let (logical_address, _page_number, offset, access) = page_numbers_zipped[i];
+        let instruction = access == Access::Fetch;
 
-        if !tlb.contains(*page_number) {
+        if !tlb.lookup(*page_number, instruction) {
             // If this page number is in RAM but not in TLB
-            if let Some(idx) = ram_frames.iter().position(|entry| entry.pn == *page_number) {
+            if let Some(idx) = page_table.walk(*page_number) {
                 // We have a soft miss
+                frame = idx;
+                replacer.touch(idx, *page_number, i);
                 if !args.debug {
                     page_frame_idx = idx;
                 }
@@ -182,86 +120,251 @@ fn main() {
                     ram_frames.push(PageTableEntry {
                         insertion_time: i,
                         pn: *page_number,
+                        referenced: true,
+                        dirty: false,
                     });
+                    page_table.map(*page_number, page_frame_idx);
                 } else {
                     // When full, eject from the page table using strategy
-                    let (frame_idx, ejected_page_number) =
-                        args.pra.algorithm(&mut ram_frames, &page_numbers, i);
-                    tlb.remove(ejected_page_number);
-                    page_frame_idx = frame_idx;
+                    page_frame_idx = replacer.victim(&mut ram_frames, *page_number);
+                    let ejected = eject(
+                        &mut ram_frames,
+                        &mut page_table,
+                        &page_numbers,
+                        i,
+                        page_frame_idx,
+                    );
+                    tlb.remove(ejected.pn);
+                    if ejected.dirty {
+                        write_backs += 1;
+                    }
+                }
+                replacer.touch(page_frame_idx, *page_number, i);
+                frame = page_frame_idx;
+
+                // Only a fault brings the page into physical memory
+                if let Some(page) = backing_store.page(*page_number) {
+                    memory.load(frame, page);
                 }
 
                 page_faults += 1;
             }
 
-            tlb.push(*page_number);
+            tlb.insert(*page_number, instruction);
             tlb_misses += 1;
-        } else if !args.debug {
+        } else if let Some(idx) = page_table.lookup(*page_number) {
             // We have a hit, just get the index
-            if let Some(idx) = ram_frames.iter().position(|entry| entry.pn == *page_number) {
+            frame = idx;
+            replacer.touch(idx, *page_number, i);
+            if !args.debug {
                 page_frame_idx = idx;
             }
         }
 
-        // Print all the juicy info
-        let (logical_address, _page_number, offset) = page_numbers_zipped[i];
-
-        // Fetch page from backing store at page_number * PAGE_SIZE, print hex
-        if backing_store
-            .seek(SeekFrom::Start((page_number * args.page_size) as u64))
-            .is_ok()
-        {
-            let mut page = vec![0u8; args.page_size];
+        if let Some(entry) = ram_frames.get_mut(frame) {
+            entry.referenced = true;
+            entry.dirty |= access == Access::Write;
+        }
 
-            if let Ok(()) = backing_store.read_exact(&mut page) {
-                let value = page[offset] as i8;
+        if args.quiet {
+            continue;
+        }
 
-                print!("{}, {}, {}, ", logical_address, value, page_frame_idx);
-                if !args.debug {
-                    for byte in &page {
-                        print!("{:02X}", byte);
-                    }
-                }
-                println!();
+        // Print all the juicy info
+        // Read the page out of its frame, print hex (pages past the end of the
+        // backing store were never loaded and are skipped)
+        if backing_store.page(*page_number).is_some() {
+            let page = memory.frame(frame);
+            let value = page[offset] as i8;
+
+            line.clear();
+            write!(line, "{}, {}, {}, ", logical_address, value, page_frame_idx).unwrap();
+            if !args.debug {
+                push_hex(&mut line, page);
             }
+            line.push(b'\n');
+            out.write_all(&line).expect("Unable to write output!");
         }
     }
 
-    print_statistics(tlb_misses, page_faults, page_numbers.len(), args.debug);
+    print_statistics(
+        &mut out,
+        tlb_misses,
+        page_faults,
+        page_numbers.len(),
+        args.debug,
+    )
+    .and_then(|()| {
+        if args.tlb_configured() {
+            print_tlb_statistics(&mut out, &tlb, &page_table, &args, page_numbers.len())
+        } else {
+            Ok(())
+        }
+    })
+    .and_then(|()| match args.page_table {
+        PageTableKind::Flat => Ok(()),
+        _ => print_walk_statistics(&mut out, &page_table, args.debug),
+    })
+    .and_then(|()| {
+        // Only traces with writes can dirty a page
+        if page_numbers_zipped
+            .iter()
+            .any(|(.., access)| *access == Access::Write)
+        {
+            writeln!(out, "Dirty Page Write-backs = {}", write_backs)
+        } else {
+            Ok(())
+        }
+    })
+    .and_then(|()| out.flush())
+    .expect("Unable to write output!");
 }
 
 /* HELPER FUNCTIONS */
+fn parse_access(line: &str) -> Option<(usize, Access)> {
+    /* Parses "<address>" or "D <address>" (read), "W <address>" (write) or "I <address>" (instruction fetch) */
+    let line = line.trim();
+    let (access, address) = match line.split_once(char::is_whitespace) {
+        Some(("D", address)) => (Access::Read, address),
+        Some(("W", address)) => (Access::Write, address),
+        Some(("I", address)) => (Access::Fetch, address),
+        _ => (Access::Read, line),
+    };
+    address.trim().parse().ok().map(|address| (address, access))
+}
+
+// Uppercase hex digits of every byte value
+const HEX: [[u8; 2]; 256] = {
+    const DIGITS: &[u8; 16] = b"0123456789ABCDEF";
+    let mut table = [[0u8; 2]; 256];
+    let mut byte = 0;
+    while byte < 256 {
+        table[byte] = [DIGITS[byte >> 4], DIGITS[byte & 0xF]];
+        byte += 1;
+    }
+    table
+};
+
+fn push_hex(line: &mut Vec<u8>, bytes: &[u8]) {
+    /* Appends the bytes as uppercase hex, two digits each */
+    line.reserve(bytes.len() * 2);
+    for byte in bytes {
+        line.extend_from_slice(&HEX[*byte as usize]);
+    }
+}
+
 fn eject(
     ram_frames: &mut [PageTableEntry], // Pass a slice instead of a vector
+    page_table: &mut PageTable,
     all_pns: &[usize],
     present_idx: usize,
     replace_idx: usize,
-) -> usize {
-    let ejected_pn = ram_frames[replace_idx].pn;
-    ram_frames[replace_idx] = PageTableEntry {
-        insertion_time: present_idx,
-        pn: all_pns[present_idx],
-    };
-    ejected_pn
+) -> PageTableEntry {
+    let ejected = std::mem::replace(
+        &mut ram_frames[replace_idx],
+        PageTableEntry {
+            insertion_time: present_idx,
+            pn: all_pns[present_idx],
+            referenced: true,
+            dirty: false,
+        },
+    );
+    page_table.unmap(ejected.pn);
+    page_table.map(all_pns[present_idx], replace_idx);
+    ejected
 }
 
-fn print_statistics(tlb_misses: usize, page_faults: usize, addresses: usize, debug: bool) {
+fn print_statistics(
+    out: &mut impl Write,
+    tlb_misses: usize,
+    page_faults: usize,
+    addresses: usize,
+    debug: bool,
+) -> io::Result<()> {
     /* Prints statistics from TLB and RAM Operations */
     let hits = addresses - tlb_misses;
     if debug {
-        println!("***********************************");
+        writeln!(out, "***********************************")?;
     }
-    println!("Number of Translated Addresses = {}", addresses);
-    println!("Page Faults = {}", page_faults);
+    writeln!(out, "Number of Translated Addresses = {}", addresses)?;
+    writeln!(out, "Page Faults = {}", page_faults)?;
     if !debug {
-        println!(
+        writeln!(
+            out,
             "Page Fault Rate = {:.3}",
             page_faults as f64 / addresses as f64,
-        );
+        )?;
     }
-    println!("TLB Hits = {}", hits);
-    println!("TLB Misses = {}", tlb_misses);
+    writeln!(out, "TLB Hits = {}", hits)?;
+    writeln!(out, "TLB Misses = {}", tlb_misses)?;
     if !debug {
-        println!("TLB Hit Rate = {:.3}", hits as f64 / addresses as f64,);
+        writeln!(out, "TLB Hit Rate = {:.3}", hits as f64 / addresses as f64,)?;
+    }
+    Ok(())
+}
+
+fn print_walk_statistics(
+    out: &mut impl Write,
+    page_table: &PageTable,
+    debug: bool,
+) -> io::Result<()> {
+    /* Prints the page-walk cost of the page table organization */
+    let walks = page_table.walks();
+    writeln!(out, "Page Walks = {}", walks)?;
+    writeln!(out, "Page Walk References = {}", page_table.references())?;
+    if !debug {
+        writeln!(
+            out,
+            "References Per Walk = {:.3}",
+            page_table.references() as f64 / walks.max(1) as f64,
+        )?;
+    }
+    if let Some(hits) = page_table.walk_cache_hits() {
+        writeln!(out, "Walk Cache Hits = {}", hits)?;
+        if !debug {
+            writeln!(
+                out,
+                "Walk Cache Hit Rate = {:.3}",
+                hits as f64 / walks.max(1) as f64,
+            )?;
+        }
+    }
+    Ok(())
+}
+
+fn print_tlb_statistics(
+    out: &mut impl Write,
+    tlb: &TlbHierarchy,
+    page_table: &PageTable,
+    args: &Cli,
+    addresses: usize,
+) -> io::Result<()> {
+    /* Prints per-level TLB statistics and the modeled translation latency */
+    for (name, level) in tlb.levels() {
+        writeln!(out, "{} TLB Hits = {}", name, level.hits())?;
+        writeln!(
+            out,
+            "{} TLB Misses = {}",
+            name,
+            level.lookups() - level.hits()
+        )?;
+        if !args.debug {
+            writeln!(
+                out,
+                "{} TLB Hit Rate = {:.3}",
+                name,
+                level.hits() as f64 / level.lookups().max(1) as f64,
+            )?;
+        }
+    }
+    let cycles = tlb.lookup_cycles() + page_table.references() * args.memory_latency;
+    writeln!(out, "Translation Cycles = {}", cycles)?;
+    if !args.debug {
+        writeln!(
+            out,
+            "Average Translation Latency = {:.3}",
+            cycles as f64 / addresses.max(1) as f64,
+        )?;
     }
+    Ok(())
 }
@@ -0,0 +1,102 @@
+use std::{fs, io, os::unix::io::AsRawFd, path::Path, ptr, slice};
+
+/// BACKING_STORE.bin mapped read-only into memory once
+///
+/// Pages are served as slices straight out of the mapping, so fetching a page
+/// costs no syscall and no copy.
+pub struct BackingStore {
+    data: *const u8,
+    len: usize,
+    page_size: usize,
+}
+
+impl BackingStore {
+    pub fn open(path: &Path, page_size: usize) -> io::Result<Self> {
+        let file = fs::File::open(path)?;
+        let len = file.metadata()?.len() as usize;
+
+        // mmap() rejects empty mappings; an empty store just has no pages
+        if len == 0 {
+            return Ok(Self {
+                data: ptr::null(),
+                len,
+                page_size,
+            });
+        }
+
+        // SAFETY: a fresh private read-only mapping of a file we opened; the
+        // descriptor may be closed once the mapping exists
+        let data = unsafe {
+            libc::mmap(
+                ptr::null_mut(),
+                len,
+                libc::PROT_READ,
+                libc::MAP_PRIVATE,
+                file.as_raw_fd(),
+                0,
+            )
+        };
+        if data == libc::MAP_FAILED {
+            return Err(io::Error::last_os_error());
+        }
+
+        Ok(Self {
+            data: data as *const u8,
+            len,
+            page_size,
+        })
+    }
+
+    /// Contents of page `pn`, or None if the store is too short to hold it
+    pub fn page(&self, pn: usize) -> Option<&[u8]> {
+        let start = pn.checked_mul(self.page_size)?;
+        if start.checked_add(self.page_size)? > self.len {
+            return None;
+        }
+        // SAFETY: in bounds of a mapping that lives as long as self
+        Some(unsafe { slice::from_raw_parts(self.data.add(start), self.page_size) })
+    }
+}
+
+impl Drop for BackingStore {
+    fn drop(&mut self) {
+        if !self.data.is_null() {
+            // SAFETY: unmaps exactly the mapping created in open()
+            unsafe {
+                libc::munmap(self.data as *mut libc::c_void, self.len);
+            }
+        }
+    }
+}
+
+/// Simulated physical memory: one page-sized slot per frame
+///
+/// Pages are copied in from the backing store only when they fault into a
+/// frame, the way an MMU loads them; every other reference reads RAM.
+pub struct PhysicalMemory {
+    bytes: Vec<u8>,
+    page_size: usize,
+}
+
+impl PhysicalMemory {
+    pub fn new(page_size: usize) -> Self {
+        Self {
+            bytes: Vec::new(), // Grows as frames are first filled
+            page_size,
+        }
+    }
+
+    /// Copy `page` into `frame`
+    pub fn load(&mut self, frame: usize, page: &[u8]) {
+        let start = frame * self.page_size;
+        if self.bytes.len() < start + self.page_size {
+            self.bytes.resize(start + self.page_size, 0);
+        }
+        self.bytes[start..start + self.page_size].copy_from_slice(page);
+    }
+
+    pub fn frame(&self, frame: usize) -> &[u8] {
+        let start = frame * self.page_size;
+        &self.bytes[start..start + self.page_size]
+    }
+}
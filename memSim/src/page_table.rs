@@ -0,0 +1,453 @@
+use crate::cli::PageTableKind;
+use std::collections::HashMap;
+
+// Largest address space whose flat page table is an array
+const DENSE_PAGES: usize = 1 << 16;
+
+// Widest index a radix node may take (2^20 entries per node)
+const MAX_RADIX_BITS: u32 = 20;
+
+// Empty slot in a radix node, hash chain or inverted table
+const NONE: usize = usize::MAX;
+
+/// How a virtual address splits into page number and offset
+///
+/// Offset bits come from the page size, which must be a power of two; the page
+/// number is whatever remains of the `address_bits` wide virtual address.
+/// Addresses wider than that are truncated.
+pub struct AddressFormat {
+    offset_bits: u32,
+    address_mask: usize,
+}
+
+impl AddressFormat {
+    pub fn new(address_bits: u32, page_size: usize) -> Self {
+        Self {
+            offset_bits: page_size.trailing_zeros(),
+            address_mask: usize::MAX >> (usize::BITS - address_bits),
+        }
+    }
+
+    pub fn page_number_bits(&self) -> u32 {
+        self.address_mask.count_ones() - self.offset_bits
+    }
+
+    /// Split an address into (page number, offset)
+    pub fn split(&self, address: usize) -> (usize, usize) {
+        let address = address & self.address_mask;
+        (
+            address >> self.offset_bits,
+            address & ((1 << self.offset_bits) - 1),
+        )
+    }
+}
+
+/// Page number -> frame index, in one of several organizations
+///
+/// `walk` is the translation done on a TLB miss and counts the memory
+/// references the organization needs for it; `lookup` is the simulator's own
+/// bookkeeping and costs nothing. `map` and `unmap` are the fault handler's
+/// updates and are not counted either.
+pub struct PageTable {
+    table: Table,
+    walks: usize,
+    references: usize,
+}
+
+enum Table {
+    Flat(Flat),
+    Radix(Radix),
+    Hashed(Hashed),
+    Inverted(Inverted),
+}
+
+impl PageTable {
+    pub fn new(
+        kind: &PageTableKind,
+        format: &AddressFormat,
+        frames: usize,
+        walk_cache: usize,
+    ) -> Result<Self, String> {
+        let levels = match kind {
+            PageTableKind::Radix2 => 2,
+            PageTableKind::Radix3 => 3,
+            PageTableKind::Radix4 => 4,
+            _ => 0,
+        };
+        if levels == 0 && walk_cache > 0 {
+            return Err("the walk cache needs a radix page table".to_string());
+        }
+
+        let table = match kind {
+            PageTableKind::Flat => Table::Flat(Flat::new(format)),
+            PageTableKind::Hashed => Table::Hashed(Hashed::new(frames)),
+            PageTableKind::Inverted => Table::Inverted(Inverted::new(frames)),
+            _ => Table::Radix(Radix::new(format, levels, walk_cache)?),
+        };
+        Ok(Self {
+            table,
+            walks: 0,
+            references: 0,
+        })
+    }
+
+    /// Translate `pn` as the MMU would on a TLB miss, counting the references
+    pub fn walk(&mut self, pn: usize) -> Option<usize> {
+        let (frame, references) = match &mut self.table {
+            Table::Flat(flat) => (flat.lookup(pn), 1),
+            Table::Radix(radix) => radix.walk(pn),
+            Table::Hashed(hashed) => hashed.find(pn),
+            Table::Inverted(inverted) => inverted.find(pn),
+        };
+        self.walks += 1;
+        self.references += references;
+        frame
+    }
+
+    pub fn lookup(&self, pn: usize) -> Option<usize> {
+        match &self.table {
+            Table::Flat(flat) => flat.lookup(pn),
+            Table::Radix(radix) => radix
+                .leaf(pn)
+                .and_then(|(node, idx)| radix.frame(node, idx)),
+            Table::Hashed(hashed) => hashed.find(pn).0,
+            Table::Inverted(inverted) => inverted.find(pn).0,
+        }
+    }
+
+    pub fn map(&mut self, pn: usize, frame: usize) {
+        match &mut self.table {
+            Table::Flat(flat) => flat.map(pn, frame),
+            Table::Radix(radix) => radix.map(pn, frame),
+            Table::Hashed(hashed) => hashed.map(pn, frame),
+            Table::Inverted(inverted) => inverted.map(pn, frame),
+        }
+    }
+
+    pub fn unmap(&mut self, pn: usize) {
+        match &mut self.table {
+            Table::Flat(flat) => flat.unmap(pn),
+            Table::Radix(radix) => radix.unmap(pn),
+            Table::Hashed(hashed) => hashed.unmap(pn),
+            Table::Inverted(inverted) => inverted.unmap(pn),
+        }
+    }
+
+    pub fn walks(&self) -> usize {
+        self.walks
+    }
+
+    pub fn references(&self) -> usize {
+        self.references
+    }
+
+    /// Walks that started at the leaf level thanks to the walk cache
+    pub fn walk_cache_hits(&self) -> Option<usize> {
+        match &self.table {
+            Table::Radix(radix) if radix.cache.is_some() => Some(radix.cache_hits),
+            _ => None,
+        }
+    }
+}
+
+/// Single-level table: one reference per walk
+///
+/// Small address spaces get one slot per page; larger ones only hold the
+/// resident pages, in a hash map.
+enum Flat {
+    Dense(Vec<Option<usize>>),
+    Sparse(HashMap<usize, usize>),
+}
+
+impl Flat {
+    fn new(format: &AddressFormat) -> Self {
+        match 1usize.checked_shl(format.page_number_bits()) {
+            Some(pages) if pages <= DENSE_PAGES => Flat::Dense(vec![None; pages]),
+            _ => Flat::Sparse(HashMap::new()),
+        }
+    }
+
+    fn lookup(&self, pn: usize) -> Option<usize> {
+        match self {
+            Flat::Dense(frames) => frames[pn],
+            Flat::Sparse(frames) => frames.get(&pn).copied(),
+        }
+    }
+
+    fn map(&mut self, pn: usize, frame: usize) {
+        match self {
+            Flat::Dense(frames) => frames[pn] = Some(frame),
+            Flat::Sparse(frames) => {
+                frames.insert(pn, frame);
+            }
+        }
+    }
+
+    fn unmap(&mut self, pn: usize) {
+        match self {
+            Flat::Dense(frames) => frames[pn] = None,
+            Flat::Sparse(frames) => {
+                frames.remove(&pn);
+            }
+        }
+    }
+}
+
+/// 2- to 4-level radix tree, one reference per level visited
+///
+/// The page number is cut into one index per level, upper levels taking the
+/// spare bits. Nodes are allocated on first use and kept once empty. The
+/// optional walk cache remembers, per leaf node, the upper-level prefix that
+/// leads to it, so a hit costs only the leaf reference.
+struct Radix {
+    nodes: Vec<Vec<usize>>, // Node 0 is the root; leaves hold frames
+    shifts: Vec<u32>,       // Level -> shift of its index in the page number
+    masks: Vec<usize>,      // Level -> mask of its index
+    cache: Option<WalkCache>,
+    cache_hits: usize,
+}
+
+impl Radix {
+    fn new(format: &AddressFormat, levels: usize, walk_cache: usize) -> Result<Self, String> {
+        let bits = format.page_number_bits();
+        let mut shifts = Vec::with_capacity(levels);
+        let mut masks = Vec::with_capacity(levels);
+        let mut shift = bits;
+        for level in 0..levels as u32 {
+            let width = bits / levels as u32 + u32::from(level < bits % levels as u32);
+            if width > MAX_RADIX_BITS {
+                return Err(format!(
+                    "{} radix levels leave {}-bit indices; use more levels or larger pages",
+                    levels, width
+                ));
+            }
+            shift -= width;
+            shifts.push(shift);
+            masks.push((1 << width) - 1);
+        }
+
+        Ok(Self {
+            nodes: vec![vec![NONE; masks[0] + 1]],
+            shifts,
+            masks,
+            cache: (walk_cache > 0).then(|| WalkCache::new(walk_cache)),
+            cache_hits: 0,
+        })
+    }
+
+    fn index(&self, pn: usize, level: usize) -> usize {
+        (pn >> self.shifts[level]) & self.masks[level]
+    }
+
+    fn frame(&self, node: usize, idx: usize) -> Option<usize> {
+        Some(self.nodes[node][idx]).filter(|frame| *frame != NONE)
+    }
+
+    /// Leaf node and index holding `pn`, if the path to it exists
+    fn leaf(&self, pn: usize) -> Option<(usize, usize)> {
+        let leaf_level = self.shifts.len() - 1;
+        let mut node = 0;
+        for level in 0..leaf_level {
+            node = self.nodes[node][self.index(pn, level)];
+            if node == NONE {
+                return None;
+            }
+        }
+        Some((node, self.index(pn, leaf_level)))
+    }
+
+    fn walk(&mut self, pn: usize) -> (Option<usize>, usize) {
+        let leaf_level = self.shifts.len() - 1;
+        let idx = self.index(pn, leaf_level);
+        let prefix = pn >> self.masks[leaf_level].count_ones(); // Upper-level indices
+
+        if let Some(cache) = &mut self.cache {
+            if let Some(node) = cache.lookup(prefix) {
+                self.cache_hits += 1;
+                return (self.frame(node, idx), 1);
+            }
+        }
+
+        let mut node = 0;
+        for level in 0..leaf_level {
+            node = self.nodes[node][self.index(pn, level)];
+            if node == NONE {
+                return (None, level + 1);
+            }
+        }
+        if let Some(cache) = &mut self.cache {
+            cache.insert(prefix, node);
+        }
+        (self.frame(node, idx), self.shifts.len())
+    }
+
+    fn map(&mut self, pn: usize, frame: usize) {
+        let leaf_level = self.shifts.len() - 1;
+        let mut node = 0;
+        for level in 0..leaf_level {
+            let idx = self.index(pn, level);
+            if self.nodes[node][idx] == NONE {
+                self.nodes[node][idx] = self.nodes.len();
+                self.nodes.push(vec![NONE; self.masks[level + 1] + 1]);
+            }
+            node = self.nodes[node][idx];
+        }
+        let idx = self.index(pn, leaf_level);
+        self.nodes[node][idx] = frame;
+    }
+
+    fn unmap(&mut self, pn: usize) {
+        if let Some((node, idx)) = self.leaf(pn) {
+            self.nodes[node][idx] = NONE;
+        }
+    }
+}
+
+/// Small fully associative LRU cache of prefix -> leaf node
+struct WalkCache {
+    entries: Vec<(usize, usize, usize)>, // Prefix, leaf node, last use
+    capacity: usize,
+    clock: usize,
+}
+
+impl WalkCache {
+    fn new(capacity: usize) -> Self {
+        Self {
+            entries: Vec::with_capacity(capacity),
+            capacity,
+            clock: 0,
+        }
+    }
+
+    fn lookup(&mut self, prefix: usize) -> Option<usize> {
+        self.clock += 1;
+        let entry = self.entries.iter_mut().find(|entry| entry.0 == prefix)?;
+        entry.2 = self.clock;
+        Some(entry.1)
+    }
+
+    fn insert(&mut self, prefix: usize, node: usize) {
+        if self.entries.len() < self.capacity {
+            self.entries.push((prefix, node, self.clock));
+        } else if let Some(oldest) = self.entries.iter_mut().min_by_key(|entry| entry.2) {
+            *oldest = (prefix, node, self.clock);
+        }
+    }
+}
+
+// Bucket of `pn` among 2^bits buckets (Fibonacci hashing)
+fn bucket(pn: usize, bits: u32) -> usize {
+    ((pn as u64).wrapping_mul(0x9E37_79B9_7F4A_7C15) >> (64 - bits)) as usize
+}
+
+// Hash table size for a given number of frames, at least two buckets
+fn bucket_bits(frames: usize) -> u32 {
+    frames.max(2).next_power_of_two().trailing_zeros()
+}
+
+/// Hashed page table: buckets of chained (page, frame) entries
+///
+/// A walk reads the bucket and then each chain entry up to the match, so it
+/// costs one reference per entry examined (at least one for an empty bucket).
+struct Hashed {
+    buckets: Vec<Vec<(usize, usize)>>,
+    bits: u32,
+}
+
+impl Hashed {
+    fn new(frames: usize) -> Self {
+        let bits = bucket_bits(frames);
+        Self {
+            buckets: (0..1usize << bits).map(|_| Vec::new()).collect(),
+            bits,
+        }
+    }
+
+    fn find(&self, pn: usize) -> (Option<usize>, usize) {
+        let chain = &self.buckets[bucket(pn, self.bits)];
+        match chain.iter().position(|entry| entry.0 == pn) {
+            Some(idx) => (Some(chain[idx].1), idx + 1),
+            None => (None, chain.len().max(1)),
+        }
+    }
+
+    fn map(&mut self, pn: usize, frame: usize) {
+        self.buckets[bucket(pn, self.bits)].push((pn, frame));
+    }
+
+    fn unmap(&mut self, pn: usize) {
+        let chain = &mut self.buckets[bucket(pn, self.bits)];
+        if let Some(idx) = chain.iter().position(|entry| entry.0 == pn) {
+            chain.remove(idx);
+        }
+    }
+}
+
+/// Inverted page table: one entry per frame, found through a hash anchor table
+///
+/// The frame is the position of the matching entry. A walk reads the anchor
+/// and then each entry of the chain up to the match.
+struct Inverted {
+    anchors: Vec<usize>,         // Bucket -> first frame of its chain
+    entries: Vec<InvertedEntry>, // Frame index -> resident page
+    bits: u32,
+}
+
+struct InvertedEntry {
+    pn: usize,
+    next: usize, // Next frame in the same chain
+}
+
+impl Inverted {
+    fn new(frames: usize) -> Self {
+        let bits = bucket_bits(frames);
+        Self {
+            anchors: vec![NONE; 1 << bits],
+            entries: Vec::new(), // Grows as frames are first filled
+            bits,
+        }
+    }
+
+    fn find(&self, pn: usize) -> (Option<usize>, usize) {
+        let mut references = 1;
+        let mut frame = self.anchors[bucket(pn, self.bits)];
+        while frame != NONE {
+            references += 1;
+            if self.entries[frame].pn == pn {
+                return (Some(frame), references);
+            }
+            frame = self.entries[frame].next;
+        }
+        (None, references)
+    }
+
+    fn map(&mut self, pn: usize, frame: usize) {
+        let anchor = &mut self.anchors[bucket(pn, self.bits)];
+        let entry = InvertedEntry { pn, next: *anchor };
+        if frame == self.entries.len() {
+            self.entries.push(entry);
+        } else {
+            self.entries[frame] = entry;
+        }
+        *anchor = frame;
+    }
+
+    fn unmap(&mut self, pn: usize) {
+        let anchor = bucket(pn, self.bits);
+        let mut previous = NONE;
+        let mut frame = self.anchors[anchor];
+        while frame != NONE && self.entries[frame].pn != pn {
+            previous = frame;
+            frame = self.entries[frame].next;
+        }
+        if frame == NONE {
+            return;
+        }
+        let next = self.entries[frame].next;
+        if previous == NONE {
+            self.anchors[anchor] = next;
+        } else {
+            self.entries[previous].next = next;
+        }
+    }
+}
@@ -0,0 +1,544 @@
+use crate::cli::PageReplacementAlgorithm;
+use crate::PageTableEntry;
+use std::collections::{HashMap, VecDeque};
+
+// Next-use value of a page that is never referenced again
+const NEVER: usize = usize::MAX;
+
+/// Per-run state of the page replacement algorithm
+pub enum Replacer {
+    Fifo,
+    Lru(Lru),
+    Opt(Opt),
+    Clock(usize), // Hand: next frame to inspect
+    SecondChance(VecDeque<usize>),
+    Lfu(Lfu),
+    Arc(Arc),
+    TwoQ(TwoQ),
+}
+
+impl PageReplacementAlgorithm {
+    pub fn replacer(&self, all_pns: &[usize], frames: usize) -> Replacer {
+        match self {
+            PageReplacementAlgorithm::Fifo => Replacer::Fifo,
+            PageReplacementAlgorithm::Lru => Replacer::Lru(Lru::new(frames)),
+            PageReplacementAlgorithm::Opt => Replacer::Opt(Opt::new(all_pns, frames)),
+            PageReplacementAlgorithm::Clock => Replacer::Clock(0),
+            PageReplacementAlgorithm::SecondChance => {
+                Replacer::SecondChance(VecDeque::with_capacity(frames))
+            }
+            PageReplacementAlgorithm::Lfu => Replacer::Lfu(Lfu::new(frames)),
+            PageReplacementAlgorithm::Arc => Replacer::Arc(Arc::new(frames)),
+            PageReplacementAlgorithm::TwoQ => Replacer::TwoQ(TwoQ::new(frames)),
+        }
+    }
+}
+
+impl Replacer {
+    /// Record that page `pn` in `frame` was referenced at `present_idx` (hit or freshly loaded)
+    pub fn touch(&mut self, frame: usize, pn: usize, present_idx: usize) {
+        match self {
+            Replacer::Fifo | Replacer::Clock(_) => {}
+            Replacer::Lru(lru) => lru.touch(frame),
+            Replacer::Opt(opt) => opt.touch(frame, present_idx),
+            Replacer::SecondChance(queue) => {
+                if frame == queue.len() {
+                    queue.push_back(frame);
+                }
+            }
+            Replacer::Lfu(lfu) => lfu.touch(frame),
+            Replacer::Arc(arc) => arc.touch(frame, pn),
+            Replacer::TwoQ(two_q) => two_q.touch(frame, pn),
+        }
+    }
+
+    /// Pick the frame to eject so that page `pn` can be loaded
+    ///
+    /// CLOCK and second chance clear the referenced bits they pass over.
+    pub fn victim(&mut self, ram_frames: &mut [PageTableEntry], pn: usize) -> usize {
+        match self {
+            Replacer::Fifo => fifo(ram_frames),
+            Replacer::Lru(lru) => lru.victim(),
+            Replacer::Opt(opt) => opt.victim(),
+            Replacer::Clock(hand) => clock(ram_frames, hand),
+            Replacer::SecondChance(queue) => second_chance(ram_frames, queue),
+            Replacer::Lfu(lfu) => lfu.victim(),
+            Replacer::Arc(arc) => arc.victim(pn),
+            Replacer::TwoQ(two_q) => two_q.victim(),
+        }
+    }
+}
+
+/// LRU as an intrusive doubly-linked recency list over frame indices
+///
+/// Every reference moves its frame to the front, so the least recently used
+/// frame is always at the back: O(1) per reference and per eviction.
+pub struct Lru {
+    prev: Vec<Option<usize>>, // Frame index -> more recently used neighbour
+    next: Vec<Option<usize>>, // Frame index -> less recently used neighbour
+    front: Option<usize>,
+    back: Option<usize>,
+}
+
+impl Lru {
+    pub fn new(frames: usize) -> Self {
+        Self {
+            prev: Vec::with_capacity(frames),
+            next: Vec::with_capacity(frames),
+            front: None,
+            back: None,
+        }
+    }
+
+    fn touch(&mut self, frame: usize) {
+        if frame == self.prev.len() {
+            // A frame being filled for the first time
+            self.prev.push(None);
+            self.next.push(None);
+        } else if self.front == Some(frame) {
+            return;
+        } else {
+            // Unlink; the frame is not the front, so it has a predecessor
+            let before = self.prev[frame].expect("frame behind the front");
+            let after = self.next[frame];
+            self.next[before] = after;
+            match after {
+                Some(after) => self.prev[after] = Some(before),
+                None => self.back = Some(before),
+            }
+        }
+
+        self.prev[frame] = None;
+        self.next[frame] = self.front;
+        match self.front {
+            Some(front) => self.prev[front] = Some(frame),
+            None => self.back = Some(frame),
+        }
+        self.front = Some(frame);
+    }
+
+    fn victim(&self) -> usize {
+        self.back.expect("all frames are in the list")
+    }
+}
+
+/// Index of the next reference to the page referenced at each index (NEVER
+/// if there is none), in one backwards pass
+pub fn next_uses(all_pns: &[usize]) -> Vec<usize> {
+    let mut next_use = vec![NEVER; all_pns.len()];
+    let mut seen: HashMap<usize, usize> = HashMap::new();
+    for (idx, pn) in all_pns.iter().enumerate().rev() {
+        if let Some(later) = seen.insert(*pn, idx) {
+            next_use[idx] = later;
+        }
+    }
+    next_use
+}
+
+/// Belady's OPT in O(log frames) per reference
+///
+/// `next_use[i]` is the index of the next reference to the page referenced at
+/// `i` (see `next_uses`). Frames sit in an indexed max-heap keyed by
+/// the next use of the page they hold, so the victim is always at the top.
+/// Ties (pages never used again) go to the lowest frame index, as the linear
+/// scan did.
+pub struct Opt {
+    next_use: Vec<usize>,
+    heap: Vec<usize>,     // Frame indices
+    position: Vec<usize>, // Frame index -> slot in `heap`
+    key: Vec<usize>,      // Frame index -> next use of its page
+}
+
+impl Opt {
+    pub fn new(all_pns: &[usize], frames: usize) -> Self {
+        Self {
+            next_use: next_uses(all_pns),
+            heap: Vec::with_capacity(frames),
+            position: Vec::with_capacity(frames),
+            key: Vec::with_capacity(frames),
+        }
+    }
+
+    fn touch(&mut self, frame: usize, present_idx: usize) {
+        let next = self.next_use[present_idx];
+
+        // A frame being filled for the first time joins the heap
+        if frame == self.key.len() {
+            self.key.push(next);
+            self.position.push(self.heap.len());
+            self.heap.push(frame);
+            self.sift_up(self.heap.len() - 1);
+            return;
+        }
+
+        let old = self.key[frame];
+        self.key[frame] = next;
+        if next > old {
+            self.sift_up(self.position[frame]);
+        } else {
+            self.sift_down(self.position[frame]);
+        }
+    }
+
+    fn victim(&self) -> usize {
+        self.heap[0]
+    }
+
+    // Whether frame `a` should be ejected before frame `b`
+    fn before(&self, a: usize, b: usize) -> bool {
+        self.key[a] > self.key[b] || (self.key[a] == self.key[b] && a < b)
+    }
+
+    fn swap(&mut self, i: usize, j: usize) {
+        self.heap.swap(i, j);
+        self.position[self.heap[i]] = i;
+        self.position[self.heap[j]] = j;
+    }
+
+    fn sift_up(&mut self, mut slot: usize) {
+        while slot > 0 {
+            let parent = (slot - 1) / 2;
+            if !self.before(self.heap[slot], self.heap[parent]) {
+                break;
+            }
+            self.swap(slot, parent);
+            slot = parent;
+        }
+    }
+
+    fn sift_down(&mut self, mut slot: usize) {
+        loop {
+            let mut first = slot;
+            for child in [2 * slot + 1, 2 * slot + 2] {
+                if child < self.heap.len() && self.before(self.heap[child], self.heap[first]) {
+                    first = child;
+                }
+            }
+            if first == slot {
+                break;
+            }
+            self.swap(slot, first);
+            slot = first;
+        }
+    }
+}
+
+fn fifo(ram_frames: &[PageTableEntry]) -> usize {
+    let mut oldest_time = usize::MAX;
+    let mut oldest_idx: usize = 0;
+
+    // For each page number in the page table
+    for (idx, entry) in ram_frames.iter().enumerate() {
+        // Find if this is the oldest page number inserted into the page table
+        if entry.insertion_time < oldest_time {
+            oldest_time = entry.insertion_time;
+            oldest_idx = idx;
+        }
+    }
+
+    oldest_idx
+}
+
+/// CLOCK: sweep the hand over the frames, clearing referenced bits, and take
+/// the first frame whose bit is already clear
+///
+/// Each bit cleared was set by a reference, so a sweep is O(1) amortized.
+fn clock(ram_frames: &mut [PageTableEntry], hand: &mut usize) -> usize {
+    loop {
+        let frame = *hand;
+        *hand = (*hand + 1) % ram_frames.len();
+        if !ram_frames[frame].referenced {
+            return frame;
+        }
+        ram_frames[frame].referenced = false;
+    }
+}
+
+/// Second chance: FIFO, except that a referenced page at the head has its
+/// bit cleared and goes to the tail instead of being ejected
+///
+/// This picks the same victims as CLOCK, by moving pages rather than a hand.
+/// The victim's frame goes to the tail, as it is about to hold the newest page.
+fn second_chance(ram_frames: &mut [PageTableEntry], queue: &mut VecDeque<usize>) -> usize {
+    loop {
+        let frame = queue.pop_front().unwrap_or(0);
+        queue.push_back(frame);
+        if !ram_frames[frame].referenced {
+            return frame;
+        }
+        ram_frames[frame].referenced = false;
+    }
+}
+
+/// LFU in O(1): frames are kept in one recency list per reference count
+///
+/// The victim is the least recently used frame among those with the lowest
+/// count. Counts start over when a page is loaded.
+pub struct Lfu {
+    count: Vec<usize>,        // Frame index -> references since load, 0 once ejected
+    prev: Vec<Option<usize>>, // Frame index -> more recent neighbour with the same count
+    next: Vec<Option<usize>>, // Frame index -> less recent neighbour with the same count
+    lists: HashMap<usize, (usize, usize)>, // Non-empty count -> (most, least) recent frame
+    min_count: usize,
+}
+
+impl Lfu {
+    pub fn new(frames: usize) -> Self {
+        Self {
+            count: Vec::with_capacity(frames),
+            prev: Vec::with_capacity(frames),
+            next: Vec::with_capacity(frames),
+            lists: HashMap::new(),
+            min_count: 0,
+        }
+    }
+
+    fn unlink(&mut self, frame: usize) {
+        let count = self.count[frame];
+        let (before, after) = (self.prev[frame], self.next[frame]);
+        if let Some(before) = before {
+            self.next[before] = after;
+        }
+        if let Some(after) = after {
+            self.prev[after] = before;
+        }
+        let list = self
+            .lists
+            .get_mut(&count)
+            .expect("frame is in its count's list");
+        match (before, after) {
+            (None, None) => {
+                self.lists.remove(&count);
+            }
+            (None, Some(after)) => list.0 = after,
+            (Some(before), None) => list.1 = before,
+            (Some(_), Some(_)) => {}
+        }
+    }
+
+    fn link(&mut self, frame: usize) {
+        self.prev[frame] = None;
+        match self.lists.get_mut(&self.count[frame]) {
+            Some(list) => {
+                self.next[frame] = Some(list.0);
+                self.prev[list.0] = Some(frame);
+                list.0 = frame;
+            }
+            None => {
+                self.next[frame] = None;
+                self.lists.insert(self.count[frame], (frame, frame));
+            }
+        }
+    }
+
+    fn touch(&mut self, frame: usize) {
+        if frame == self.count.len() {
+            self.count.push(0);
+            self.prev.push(None);
+            self.next.push(None);
+        }
+
+        if self.count[frame] == 0 {
+            // Freshly loaded
+            self.min_count = 1;
+        } else {
+            self.unlink(frame);
+            if self.count[frame] == self.min_count && !self.lists.contains_key(&self.min_count) {
+                self.min_count += 1;
+            }
+        }
+        self.count[frame] += 1;
+        self.link(frame);
+    }
+
+    fn victim(&mut self) -> usize {
+        let frame = self.lists[&self.min_count].1;
+        self.unlink(frame);
+        self.count[frame] = 0;
+        frame
+    }
+}
+
+/// Set of page numbers in recency order with O(1) insert, remove and pop
+struct PageList {
+    links: HashMap<usize, (Option<usize>, Option<usize>)>, // Page -> (more, less) recent neighbour
+    front: Option<usize>,
+    back: Option<usize>,
+}
+
+impl PageList {
+    fn new() -> Self {
+        Self {
+            links: HashMap::new(),
+            front: None,
+            back: None,
+        }
+    }
+
+    fn len(&self) -> usize {
+        self.links.len()
+    }
+
+    fn contains(&self, pn: usize) -> bool {
+        self.links.contains_key(&pn)
+    }
+
+    fn push_front(&mut self, pn: usize) {
+        self.links.insert(pn, (None, self.front));
+        match self.front {
+            Some(front) => self.links.get_mut(&front).expect("linked page").0 = Some(pn),
+            None => self.back = Some(pn),
+        }
+        self.front = Some(pn);
+    }
+
+    /// Unlink `pn`, returning whether it was present
+    fn remove(&mut self, pn: usize) -> bool {
+        let Some((before, after)) = self.links.remove(&pn) else {
+            return false;
+        };
+        match before {
+            Some(before) => self.links.get_mut(&before).expect("linked page").1 = after,
+            None => self.front = after,
+        }
+        match after {
+            Some(after) => self.links.get_mut(&after).expect("linked page").0 = before,
+            None => self.back = before,
+        }
+        true
+    }
+
+    fn pop_back(&mut self) -> Option<usize> {
+        let pn = self.back?;
+        self.remove(pn);
+        Some(pn)
+    }
+}
+
+/// Adaptive Replacement Cache (Megiddo and Modha)
+///
+/// T1 holds pages seen once recently and T2 pages seen at least twice, both in
+/// LRU order; B1 and B2 remember the pages recently ejected from each. A miss
+/// that hits a ghost list moves the target size `p` of T1 towards the list
+/// that would have kept the page. Everything is O(1) per reference.
+pub struct Arc {
+    t1: PageList,
+    t2: PageList,
+    b1: PageList,
+    b2: PageList,
+    target: usize, // p: target size of T1
+    capacity: usize,
+    frame_of: HashMap<usize, usize>, // Resident page -> frame
+}
+
+impl Arc {
+    pub fn new(frames: usize) -> Self {
+        Self {
+            t1: PageList::new(),
+            t2: PageList::new(),
+            b1: PageList::new(),
+            b2: PageList::new(),
+            target: 0,
+            capacity: frames,
+            frame_of: HashMap::new(),
+        }
+    }
+
+    fn touch(&mut self, frame: usize, pn: usize) {
+        if self.t1.remove(pn) || self.t2.remove(pn) || self.b1.remove(pn) || self.b2.remove(pn) {
+            // Seen before, whether still resident or remembered
+            self.t2.push_front(pn);
+        } else {
+            self.t1.push_front(pn);
+        }
+        self.frame_of.insert(pn, frame);
+    }
+
+    fn victim(&mut self, pn: usize) -> usize {
+        let in_b2 = self.b2.contains(pn);
+        if self.b1.contains(pn) {
+            let delta = (self.b2.len() / self.b1.len()).max(1);
+            self.target = (self.target + delta).min(self.capacity);
+        } else if in_b2 {
+            let delta = (self.b1.len() / self.b2.len()).max(1);
+            self.target = self.target.saturating_sub(delta);
+        } else if self.t1.len() + self.b1.len() == self.capacity {
+            if self.t1.len() == self.capacity {
+                // T1 fills the cache: drop its LRU page without remembering it
+                let ejected = self.t1.pop_back().expect("T1 is full");
+                return self.frame_of.remove(&ejected).expect("resident page");
+            }
+            self.b1.pop_back();
+        } else if self.t1.len() + self.t2.len() + self.b1.len() + self.b2.len() == 2 * self.capacity
+        {
+            self.b2.pop_back();
+        }
+
+        // Eject from T1 if it is over target, else from T2, remembering the page
+        let from_t1 = self.t1.len() > 0
+            && (self.t1.len() > self.target || (in_b2 && self.t1.len() == self.target));
+        let ejected = if from_t1 || self.t2.len() == 0 {
+            let ejected = self.t1.pop_back().expect("T1 is not empty");
+            self.b1.push_front(ejected);
+            ejected
+        } else {
+            let ejected = self.t2.pop_back().expect("T2 is not empty");
+            self.b2.push_front(ejected);
+            ejected
+        };
+        self.frame_of.remove(&ejected).expect("resident page")
+    }
+}
+
+/// Full 2Q (Johnson and Shasha)
+///
+/// New pages enter the FIFO A1in; pages ejected from it are remembered in the
+/// ghost FIFO A1out, and a page faulted back in from there goes to the LRU list
+/// Am. A1in is held to a quarter of the frames and A1out to half, as the paper
+/// suggests. A1out is trimmed only after the faulting page has been looked up
+/// in it, so a full A1out cannot forget the page it is about to promote.
+/// O(1) per reference.
+pub struct TwoQ {
+    a1in: PageList,
+    a1out: PageList,
+    am: PageList,
+    in_limit: usize,
+    out_limit: usize,
+    frame_of: HashMap<usize, usize>, // Resident page -> frame
+}
+
+impl TwoQ {
+    pub fn new(frames: usize) -> Self {
+        Self {
+            a1in: PageList::new(),
+            a1out: PageList::new(),
+            am: PageList::new(),
+            in_limit: (frames / 4).max(1),
+            out_limit: (frames / 2).max(1),
+            frame_of: HashMap::new(),
+        }
+    }
+
+    fn touch(&mut self, frame: usize, pn: usize) {
+        if self.am.remove(pn) || self.a1out.remove(pn) {
+            self.am.push_front(pn);
+        } else if !self.a1in.contains(pn) {
+            self.a1in.push_front(pn);
+        }
+        while self.a1out.len() > self.out_limit {
+            self.a1out.pop_back();
+        }
+        self.frame_of.insert(pn, frame);
+    }
+
+    fn victim(&mut self) -> usize {
+        let ejected = if self.a1in.len() > self.in_limit || self.am.len() == 0 {
+            let ejected = self.a1in.pop_back().expect("A1in is not empty");
+            self.a1out.push_front(ejected);
+            ejected
+        } else {
+            self.am.pop_back().expect("Am is not empty")
+        };
+        self.frame_of.remove(&ejected).expect("resident page")
+    }
+}
@@ -0,0 +1,151 @@
+use crate::replacement::next_uses;
+use std::{
+    collections::HashMap,
+    io::{self, Write},
+};
+
+/// Mattson stack-distance analysis: faults for every frame count in one pass
+///
+/// LRU and OPT are stack algorithms: a reference hits with `f` frames exactly
+/// when its page sits within the top `f` entries of the algorithm's stack. So
+/// one histogram of stack depths gives the fault count for every frame count.
+/// Depth 0 stands for a first reference, which faults at any size.
+pub struct Histogram {
+    depths: Vec<usize>, // Depth -> references at that depth
+}
+
+impl Histogram {
+    fn new() -> Self {
+        Self {
+            depths: vec![0, 0], // Always at least one frame count
+        }
+    }
+
+    fn record(&mut self, depth: usize) {
+        if depth >= self.depths.len() {
+            self.depths.resize(depth + 1, 0);
+        }
+        self.depths[depth] += 1;
+    }
+
+    /// Fault counts for 1..=deepest frames (at least 1)
+    fn faults(&self) -> Vec<usize> {
+        // References deeper than f, plus first references
+        let mut faults = vec![self.depths[0]; self.depths.len()];
+        for frames in (1..self.depths.len() - 1).rev() {
+            faults[frames] = faults[frames + 1] + self.depths[frames + 1];
+        }
+        faults.split_off(1)
+    }
+}
+
+/// LRU stack depths in O(log n) per reference
+///
+/// A Fenwick tree over trace positions marks the latest reference to every
+/// page; the depth of a reference is one more than the number of marks since
+/// the previous reference to the same page.
+pub fn lru(all_pns: &[usize]) -> Histogram {
+    let mut histogram = Histogram::new();
+    let mut tree = vec![0usize; all_pns.len() + 1];
+    let mut last: HashMap<usize, usize> = HashMap::new();
+
+    for (idx, pn) in all_pns.iter().enumerate() {
+        match last.insert(*pn, idx) {
+            Some(previous) => {
+                let newer = prefix_sum(&tree, idx) - prefix_sum(&tree, previous + 1);
+                histogram.record(newer + 1);
+                add(&mut tree, previous, -1);
+            }
+            None => histogram.record(0),
+        }
+        add(&mut tree, idx, 1);
+    }
+    histogram
+}
+
+// Marks at positions 0..end
+fn prefix_sum(tree: &[usize], end: usize) -> usize {
+    let mut sum = 0;
+    let mut i = end;
+    while i > 0 {
+        sum += tree[i];
+        i &= i - 1;
+    }
+    sum
+}
+
+fn add(tree: &mut [usize], position: usize, delta: isize) {
+    let mut i = position + 1;
+    while i < tree.len() {
+        tree[i] = tree[i].wrapping_add_signed(delta);
+        i += i & i.wrapping_neg();
+    }
+}
+
+/// OPT stack depths, with Mattson's priority update
+///
+/// The stack is kept ordered so that its top `f` pages are what OPT holds with
+/// `f` frames. On a reference at depth d the page moves to the top, and
+/// the displaced page is carried down through depths 2..d. At each depth the
+/// page needed sooner stays and the other is carried on.
+///
+/// Unlike LRU this costs O(d) per reference, not O(log n). The carry chain
+/// can rewrite every entry above the referenced page, so a search tree would
+/// not bound it either.
+pub fn opt(all_pns: &[usize]) -> Histogram {
+    let mut histogram = Histogram::new();
+    let next_use = next_uses(all_pns);
+    let mut stack: Vec<usize> = Vec::new(); // Top first
+    let mut next_of: HashMap<usize, usize> = HashMap::new(); // Page -> its next reference
+
+    for (idx, pn) in all_pns.iter().enumerate() {
+        let depth = stack.iter().position(|page| page == pn);
+        histogram.record(depth.map_or(0, |depth| depth + 1));
+        next_of.insert(*pn, next_use[idx]);
+
+        // The page goes on top; the page carried down settles at its old depth
+        let end = depth.unwrap_or(stack.len());
+        let mut carried = *pn;
+        if end > 0 {
+            carried = std::mem::replace(&mut stack[0], *pn);
+            for slot in &mut stack[1..end] {
+                if next_of[&carried] < next_of[slot] {
+                    std::mem::swap(&mut carried, slot);
+                }
+            }
+        }
+        match depth {
+            Some(depth) => stack[depth] = carried,
+            None => stack.push(carried),
+        }
+    }
+    histogram
+}
+
+/// Write the LRU and OPT miss-ratio curves as CSV, one row per frame count up
+/// to the deepest reuse; with more frames only first references fault
+pub fn write_mrc(out: &mut impl Write, all_pns: &[usize]) -> io::Result<()> {
+    let lru = lru(all_pns).faults();
+    let opt = opt(all_pns).faults();
+    let references = all_pns.len().max(1) as f64;
+
+    writeln!(
+        out,
+        "frames,lru_faults,lru_miss_ratio,opt_faults,opt_miss_ratio"
+    )?;
+    for frames in 1..=lru.len().max(opt.len()) {
+        // One curve may flatten out before the other
+        let lru_faults = lru.get(frames - 1).or(lru.last()).copied().unwrap_or(0);
+        let opt_faults = opt.get(frames - 1).or(opt.last()).copied().unwrap_or(0);
+        writeln!(
+            out,
+            "{},{},{:.6},{},{:.6}",
+            frames,
+            lru_faults,
+            lru_faults as f64 / references,
+            opt_faults,
+            opt_faults as f64 / references,
+        )?;
+    }
+    Ok(())
+}
@@ -1,30 +1,263 @@
-use linked_hash_set::LinkedHashSet;
+use crate::cli::{Cli, TlbPolicy};
 
+/// One set-associative TLB
+///
+/// Entries live in fixed-size arrays laid out set by set; a lookup scans only
+/// the ways of the page's set. Zero ways means fully associative (one set).
 pub struct Tlb {
-    entries: LinkedHashSet<usize>,
-    max_size: usize,
+    tags: Box<[Option<usize>]>, // Set * ways + way -> page number, None if empty
+    stamps: Box<[usize]>,       // Last use (LRU) or insertion time (FIFO)
+    tree: Box<[bool]>,          // Set * (ways - 1) + node -> PLRU bit, true = go right
+    ways: usize,
+    sets: usize,
+    policy: TlbPolicy,
+    clock: usize,
+    rng: u64,
+    hits: usize,
+    misses: usize,
 }
 
 impl Tlb {
-    pub fn new(size: usize) -> Self {
-        Self {
-            entries: LinkedHashSet::new(),
-            max_size: size,
+    pub fn new(entries: usize, ways: usize, policy: TlbPolicy) -> Result<Self, String> {
+        let ways = if ways == 0 { entries } else { ways };
+        if ways > entries || (ways > 0 && entries % ways != 0) {
+            return Err(format!(
+                "{} TLB entries do not divide into {}-way sets",
+                entries, ways
+            ));
+        }
+        if policy == TlbPolicy::Plru && ways > 0 && !ways.is_power_of_two() {
+            return Err(format!(
+                "pseudo-LRU needs a power-of-two number of ways, not {}",
+                ways
+            ));
+        }
+
+        let sets = if ways == 0 { 0 } else { entries / ways };
+        Ok(Self {
+            tags: vec![None; entries].into_boxed_slice(),
+            stamps: vec![0; entries].into_boxed_slice(),
+            tree: vec![false; sets * ways.saturating_sub(1)].into_boxed_slice(),
+            ways,
+            sets,
+            policy,
+            clock: 0,
+            rng: 0x2545_F491_4F6C_DD1D,
+            hits: 0,
+            misses: 0,
+        })
+    }
+
+    fn set(&self, pn: usize) -> usize {
+        pn % self.sets
+    }
+
+    /// Whether `pn` is cached, updating the replacement state on a hit
+    pub fn lookup(&mut self, pn: usize) -> bool {
+        if self.sets == 0 {
+            self.misses += 1;
+            return false;
+        }
+        let base = self.set(pn) * self.ways;
+        match self.tags[base..base + self.ways]
+            .iter()
+            .position(|tag| *tag == Some(pn))
+        {
+            Some(way) => {
+                self.hits += 1;
+                self.touch(base, way);
+                true
+            }
+            None => {
+                self.misses += 1;
+                false
+            }
+        }
+    }
+
+    /// Cache `pn`, which must not already be present
+    pub fn insert(&mut self, pn: usize) {
+        if self.sets == 0 {
+            return;
+        }
+        let base = self.set(pn) * self.ways;
+        let way = match self.tags[base..base + self.ways]
+            .iter()
+            .position(Option::is_none)
+        {
+            Some(way) => way,
+            None => self.victim(base),
+        };
+        self.tags[base + way] = Some(pn);
+        self.clock += 1;
+        self.stamps[base + way] = self.clock;
+        self.touch(base, way);
+    }
+
+    pub fn remove(&mut self, pn: usize) {
+        if self.sets == 0 {
+            return;
+        }
+        let base = self.set(pn) * self.ways;
+        if let Some(way) = self.tags[base..base + self.ways]
+            .iter()
+            .position(|tag| *tag == Some(pn))
+        {
+            self.tags[base + way] = None;
+        }
+    }
+
+    fn touch(&mut self, base: usize, way: usize) {
+        match self.policy {
+            TlbPolicy::Lru => {
+                self.clock += 1;
+                self.stamps[base + way] = self.clock;
+            }
+            TlbPolicy::Plru => {
+                // Point every node on the path away from this way
+                let tree = base / self.ways * (self.ways - 1);
+                let (mut node, mut span) = (0, self.ways);
+                while span > 1 {
+                    span /= 2;
+                    let right = way & span != 0;
+                    self.tree[tree + node] = !right;
+                    node = 2 * node + 1 + usize::from(right);
+                }
+            }
+            TlbPolicy::Fifo | TlbPolicy::Random => {}
+        }
+    }
+
+    fn victim(&mut self, base: usize) -> usize {
+        match self.policy {
+            TlbPolicy::Fifo | TlbPolicy::Lru => {
+                let stamps = &self.stamps[base..base + self.ways];
+                (0..self.ways).min_by_key(|way| stamps[*way]).unwrap_or(0)
+            }
+            TlbPolicy::Plru => {
+                // Follow the bits to the way that was not recently used
+                let tree = base / self.ways * (self.ways - 1);
+                let (mut node, mut way, mut span) = (0, 0, self.ways);
+                while span > 1 {
+                    span /= 2;
+                    if self.tree[tree + node] {
+                        way += span;
+                        node = 2 * node + 2;
+                    } else {
+                        node = 2 * node + 1;
+                    }
+                }
+                way
+            }
+            TlbPolicy::Random => {
+                // xorshift64, seeded so runs are reproducible
+                self.rng ^= self.rng << 13;
+                self.rng ^= self.rng >> 7;
+                self.rng ^= self.rng << 17;
+                (self.rng % self.ways as u64) as usize
+            }
         }
     }
 
-    pub fn push(&mut self, pn: usize) {
-        if self.entries.len() == self.max_size {
-            self.entries.pop_front();
+    pub fn hits(&self) -> usize {
+        self.hits
+    }
+
+    pub fn lookups(&self) -> usize {
+        self.hits + self.misses
+    }
+}
+
+/// L1 TLB, optionally split into instruction and data halves, backed by an
+/// optional unified L2
+///
+/// A miss in L1 looks in L2; an L2 hit is copied into L1. A page found in
+/// neither is walked and then cached at both levels. Levels are neither
+/// inclusive nor exclusive, and an ejected page is shot down everywhere.
+pub struct TlbHierarchy {
+    l1d: Tlb,
+    l1i: Option<Tlb>,
+    l2: Option<Tlb>,
+    l1_latency: usize,
+    l2_latency: usize,
+}
+
+impl TlbHierarchy {
+    pub fn new(args: &Cli) -> Result<Self, String> {
+        let l1 = || Tlb::new(args.tlb_entries, args.tlb_ways, args.tlb_policy.clone());
+        Ok(Self {
+            l1d: l1()?,
+            l1i: if args.split_tlb { Some(l1()?) } else { None },
+            l2: match args.l2_tlb_entries {
+                0 => None,
+                entries => Some(Tlb::new(
+                    entries,
+                    args.l2_tlb_ways,
+                    args.l2_tlb_policy.clone(),
+                )?),
+            },
+            l1_latency: args.l1_latency,
+            l2_latency: args.l2_latency,
+        })
+    }
+
+    fn l1(&mut self, instruction: bool) -> &mut Tlb {
+        match &mut self.l1i {
+            Some(l1i) if instruction => l1i,
+            _ => &mut self.l1d,
+        }
+    }
+
+    /// Whether any level holds `pn`
+    pub fn lookup(&mut self, pn: usize, instruction: bool) -> bool {
+        if self.l1(instruction).lookup(pn) {
+            return true;
+        }
+        let l2_hit = self.l2.as_mut().is_some_and(|l2| l2.lookup(pn));
+        if l2_hit {
+            self.l1(instruction).insert(pn);
         }
-        self.entries.insert(pn);
+        l2_hit
     }
 
-    pub fn contains(&self, pn: usize) -> bool {
-        self.entries.contains(&pn)
+    /// Cache a freshly walked translation at every level
+    pub fn insert(&mut self, pn: usize, instruction: bool) {
+        self.l1(instruction).insert(pn);
+        if let Some(l2) = &mut self.l2 {
+            l2.insert(pn);
+        }
     }
 
     pub fn remove(&mut self, pn: usize) {
-        self.entries.remove(&pn);
+        self.l1d.remove(pn);
+        if let Some(l1i) = &mut self.l1i {
+            l1i.remove(pn);
+        }
+        if let Some(l2) = &mut self.l2 {
+            l2.remove(pn);
+        }
+    }
+
+    /// Each level by name, for the statistics
+    pub fn levels(&self) -> Vec<(&'static str, &Tlb)> {
+        let mut levels = Vec::new();
+        match &self.l1i {
+            Some(l1i) => {
+                levels.push(("L1I", l1i));
+                levels.push(("L1D", &self.l1d));
+            }
+            None => levels.push(("L1", &self.l1d)),
+        }
+        if let Some(l2) = &self.l2 {
+            levels.push(("L2", l2));
+        }
+        levels
+    }
+
+    /// Cycles spent looking up the TLBs: every lookup pays L1, L1 misses pay L2
+    pub fn lookup_cycles(&self) -> usize {
+        let l1_lookups = self.l1d.lookups() + self.l1i.as_ref().map_or(0, Tlb::lookups);
+        let l2_lookups = self.l2.as_ref().map_or(0, Tlb::lookups);
+        l1_lookups * self.l1_latency + l2_lookups * self.l2_latency
     }
 }